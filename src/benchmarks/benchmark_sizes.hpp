@@ -0,0 +1,15 @@
+#ifndef MYUTILITIES_BENCHMARK_SIZES_HPP
+#define MYUTILITIES_BENCHMARK_SIZES_HPP
+
+#include <cstdint>
+#include <benchmark/benchmark.h>
+
+/// input sizes 1e3, 1e4, ..., 1e8, for the benchmarks tracked across releases.
+/// Use with ->Apply(size_decades)
+inline void size_decades (benchmark::internal::Benchmark *benchmark)
+{
+  for (int64_t size = 1000; size <= 100000000; size *= 10)
+    benchmark->Arg(size);
+}
+
+#endif //MYUTILITIES_BENCHMARK_SIZES_HPP
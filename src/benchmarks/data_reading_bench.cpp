@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+#include <boost/regex.hpp>
+#include <boost/range/adaptors.hpp>
+#include <boost/range/algorithm_ext/push_back.hpp>
+
+#include "data_reading.hpp"
+
+namespace
+{
+    /// the boost::regex + istringstream implementation that doubles_from_string used to have,
+    /// kept as a reference point
+    std::vector<double> legacy_doubles_from_string (const std::string& string)
+    {
+      static const auto float_regex =
+          boost::regex(R"(((\+|-)?[[:digit:]]+)(\.(([[:digit:]]+)?))?((e|E)((\+|-)?)[[:digit:]]+)?)");
+
+      const auto convert = [] (const std::string& s)
+      {
+          std::istringstream i(s);
+          double x;
+          i >> x;
+          return x;
+      };
+
+      std::vector<double> output;
+      boost::push_back(output, string
+                               | boost::adaptors::tokenized(float_regex)
+                               | boost::adaptors::transformed(convert));
+      return output;
+    }
+
+    /// a text table of the given shape, numbers formatted the way our trajectory dumps are
+    std::string make_table (std::size_t rows, std::size_t columns, int precision = 16)
+    {
+      std::mt19937 generator(42);
+      std::uniform_real_distribution<double> distribution(-1e3, 1e3);
+
+      std::ostringstream os;
+      os.precision(precision);
+      for (std::size_t i = 0; i < rows; ++i)
+        {
+          for (std::size_t j = 0; j < columns; ++j)
+            os << distribution(generator) << ' ';
+          os << '\n';
+        }
+      return os.str();
+    }
+
+    void BM_doubles_from_string_legacy (benchmark::State& state)
+    {
+      const auto text = make_table(static_cast<std::size_t>(state.range(0)), 6);
+
+      for (auto _ : state)
+        benchmark::DoNotOptimize(legacy_doubles_from_string(text));
+
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    }
+
+    void BM_doubles_from_string (benchmark::State& state)
+    {
+      const auto text = make_table(static_cast<std::size_t>(state.range(0)), 6);
+
+      for (auto _ : state)
+        benchmark::DoNotOptimize(PanosUtilities::doubles_from_string(text));
+
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    }
+
+    void BM_doubles_from_string_reused_buffer (benchmark::State& state)
+    {
+      const auto text = make_table(static_cast<std::size_t>(state.range(0)), 6);
+      std::vector<double> buffer;
+
+      for (auto _ : state)
+        {
+          buffer.clear();
+          PanosUtilities::doubles_from_string(text, buffer);
+          benchmark::DoNotOptimize(buffer.data());
+        }
+
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    }
+
+    /// a table of about 2^18 numbers, state.range(0) columns wide and printed with state.range(1) significant digits
+    void BM_parse_numeric_table_shape (benchmark::State& state)
+    {
+      const auto columns = static_cast<std::size_t>(state.range(0));
+      const auto text = make_table((1 << 18) / columns, columns, static_cast<int>(state.range(1)));
+
+      std::size_t values = 0;
+      for (auto _ : state)
+        {
+          const auto table = PanosUtilities::parse_numeric_table(text);
+          values = table.values().size();
+          benchmark::DoNotOptimize(table.values().data());
+        }
+
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values));
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    }
+
+    /// a table file written once and removed at exit
+    struct TableFile {
+      std::string path{"myUtilitiesBench_table.txt"};
+      int64_t size{0};
+      TableFile ()
+      {
+        const auto text = make_table(1 << 18, 6);
+        std::ofstream(path) << text;
+        size = static_cast<int64_t>(text.size());
+      }
+      ~TableFile ()
+      {
+        std::remove(path.c_str());
+      }
+    };
+
+    void BM_read_numeric_table_threads (benchmark::State& state)
+    {
+      static const TableFile file;
+      const auto n_threads = static_cast<unsigned>(state.range(0));
+
+      for (auto _ : state)
+        {
+          const auto table = PanosUtilities::read_numeric_table(file.path,
+                                                                PanosUtilities::StorageOrder::row_major,
+                                                                "#",
+                                                                n_threads);
+          benchmark::DoNotOptimize(table.values().data());
+        }
+
+      state.SetBytesProcessed(state.iterations() * file.size);
+    }
+}
+
+BENCHMARK(BM_doubles_from_string_legacy)->Range(1 << 4, 1 << 14);
+BENCHMARK(BM_doubles_from_string)->Range(1 << 4, 1 << 14);
+BENCHMARK(BM_doubles_from_string_reused_buffer)->Range(1 << 4, 1 << 14);
+BENCHMARK(BM_parse_numeric_table_shape)->ArgsProduct({{1, 6, 64, 1024}, {6, 17}});
+BENCHMARK(BM_read_numeric_table_threads)
+    ->DenseRange(1, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,255 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "interval.hpp"
+#include "interval_set.hpp"
+#include "benchmark_sizes.hpp"
+
+using namespace PanosUtilities;
+
+static std::vector<double> make_points (std::size_t size)
+{
+  std::mt19937_64 engine{42};
+  std::uniform_real_distribution<double> distribution{-2, 2};
+
+  std::vector<double> points(size);
+  std::generate(points.begin(), points.end(), [&] ()
+  { return distribution(engine); });
+  return points;
+}
+
+static void BM_is_inside_count (benchmark::State& state)
+{
+  const auto points = make_points(static_cast<std::size_t>(state.range(0)));
+  const Interval interval{-1, 1};
+
+  for (auto _ : state)
+    {
+      const auto count = std::count_if(points.cbegin(), points.cend(), [&] (double x)
+      { return is_inside(x, interval); });
+      benchmark::DoNotOptimize(count);
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_is_inside_count)->Range(1 << 10, 1 << 22);
+
+static void BM_interval_construction (benchmark::State& state)
+{
+  const auto points = make_points(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state)
+    {
+      double total_length = 0;
+      for (std::size_t i = 1; i < points.size(); ++i)
+        {
+          const Interval interval{points[i - 1], points[i]};
+          total_length += interval.max() - interval.min();
+        }
+      benchmark::DoNotOptimize(total_length);
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_interval_construction)->Range(1 << 10, 1 << 22);
+
+static void BM_is_inside_batch (benchmark::State& state)
+{
+  const auto points = make_points(static_cast<std::size_t>(state.range(0)));
+  const Interval interval{-1, 1};
+  std::vector<std::uint64_t> mask(is_inside_mask_size(points.size()));
+
+  for (auto _ : state)
+    {
+      is_inside_batch(interval, points.data(), points.data() + points.size(), mask.data());
+      benchmark::DoNotOptimize(mask.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_is_inside_batch)->Range(1 << 10, 1 << 22);
+
+static void BM_count_inside (benchmark::State& state)
+{
+  const auto points = make_points(static_cast<std::size_t>(state.range(0)));
+  const Interval interval{-1, 1};
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(count_inside(interval, points));
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(double)));
+}
+
+BENCHMARK(BM_count_inside)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_count_inside)->Apply(size_decades);
+
+static void BM_clamp_scalar_loop (benchmark::State& state)
+{
+  const auto points = make_points(static_cast<std::size_t>(state.range(0)));
+  const Interval interval{-1, 1};
+  std::vector<double> clamped(points.size());
+
+  for (auto _ : state)
+    {
+      std::transform(points.cbegin(), points.cend(), clamped.begin(), [&] (double x)
+      { return clamp(x, interval); });
+      benchmark::DoNotOptimize(clamped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_clamp_scalar_loop)->Range(1 << 10, 1 << 22);
+
+static void BM_clamp_batch (benchmark::State& state)
+{
+  const auto points = make_points(static_cast<std::size_t>(state.range(0)));
+  const Interval interval{-1, 1};
+  std::vector<double> clamped(points.size());
+
+  for (auto _ : state)
+    {
+      clamp_batch(interval, points.data(), points.data() + points.size(), clamped.data());
+      benchmark::DoNotOptimize(clamped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_clamp_batch)->Range(1 << 10, 1 << 22);
+
+static void BM_std_partition (benchmark::State& state)
+{
+  const auto original = make_points(static_cast<std::size_t>(state.range(0)));
+  const Interval interval{-1, 1};
+  auto points = original;
+
+  for (auto _ : state)
+    {
+      state.PauseTiming();
+      points = original;
+      state.ResumeTiming();
+      benchmark::DoNotOptimize(std::partition(points.begin(), points.end(), [&] (double x)
+      { return is_inside(x, interval); }));
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_std_partition)->Range(1 << 10, 1 << 22);
+
+static void BM_partition_inside (benchmark::State& state)
+{
+  const auto original = make_points(static_cast<std::size_t>(state.range(0)));
+  const Interval interval{-1, 1};
+  auto points = original;
+
+  for (auto _ : state)
+    {
+      state.PauseTiming();
+      points = original;
+      state.ResumeTiming();
+      benchmark::DoNotOptimize(partition_inside(interval, points));
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_partition_inside)->Range(1 << 10, 1 << 22);
+
+static std::vector<Interval> make_windows (std::size_t size)
+{
+  std::mt19937_64 engine{7};
+  std::uniform_real_distribution<double> distribution{-2, 2};
+
+  std::vector<Interval> windows;
+  for (std::size_t i = 0; i < size; ++i)
+    {
+      const double min = distribution(engine);
+      windows.emplace_back(min, min + 1e-4);
+    }
+  return windows;
+}
+
+static void BM_is_inside_any_window (benchmark::State& state)
+{
+  const auto points = make_points(1 << 14);
+  const auto windows = make_windows(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state)
+    {
+      std::size_t count = 0;
+      for (double x : points)
+        count += std::any_of(windows.cbegin(), windows.cend(), [=] (const Interval& window)
+        { return is_inside(x, window); });
+      benchmark::DoNotOptimize(count);
+    }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(points.size()));
+}
+
+BENCHMARK(BM_is_inside_any_window)->Range(1 << 4, 1 << 12);
+
+static void BM_interval_set_contains (benchmark::State& state)
+{
+  const auto points = make_points(1 << 14);
+  const IntervalSet windows(make_windows(static_cast<std::size_t>(state.range(0))));
+
+  for (auto _ : state)
+    {
+      std::size_t count = 0;
+      for (double x : points)
+        count += windows.contains(x);
+      benchmark::DoNotOptimize(count);
+    }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(points.size()));
+}
+
+BENCHMARK(BM_interval_set_contains)->Range(1 << 4, 1 << 16);
+
+static void BM_interval_set_contains_batch (benchmark::State& state)
+{
+  const auto points = make_points(1 << 14);
+  const IntervalSet windows(make_windows(static_cast<std::size_t>(state.range(0))));
+  std::vector<std::uint64_t> mask(is_inside_mask_size(points.size()));
+
+  for (auto _ : state)
+    {
+      windows.contains_batch(points.data(), points.data() + points.size(), mask.data());
+      benchmark::DoNotOptimize(mask.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(points.size()));
+}
+
+BENCHMARK(BM_interval_set_contains_batch)->Range(1 << 4, 1 << 16);
+
+static void BM_interval_set_contains_sorted_batch (benchmark::State& state)
+{
+  auto points = make_points(1 << 14);
+  std::sort(points.begin(), points.end());
+  const IntervalSet windows(make_windows(static_cast<std::size_t>(state.range(0))));
+  std::vector<std::uint64_t> mask(is_inside_mask_size(points.size()));
+
+  for (auto _ : state)
+    {
+      windows.contains_sorted_batch(points.data(), points.data() + points.size(), mask.data());
+      benchmark::DoNotOptimize(mask.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(points.size()));
+}
+
+BENCHMARK(BM_interval_set_contains_sorted_batch)->Range(1 << 4, 1 << 16);
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "linspace.hpp"
+#include "interval.hpp"
+#include "grid.hpp"
+#include "benchmark_sizes.hpp"
+
+using namespace PanosUtilities;
+
+static void BM_linspace (benchmark::State& state)
+{
+  const auto size = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(linspace(0, 1, size));
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_linspace)->Range(1 << 4, 1 << 20);
+
+static void BM_linspace_into (benchmark::State& state)
+{
+  std::vector<double> buffer(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state)
+    {
+      linspace_into(0, 1, buffer);
+      benchmark::DoNotOptimize(buffer.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(double)));
+}
+
+BENCHMARK(BM_linspace_into)->Range(1 << 4, 1 << 20);
+BENCHMARK(BM_linspace_into)->Apply(size_decades);
+
+static void BM_uniform_samples_exclude_min (benchmark::State& state)
+{
+  const auto size = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(uniform_samples_exclude_min(Interval(0, 1), size));
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_uniform_samples_exclude_min)->Range(1 << 4, 1 << 20);
+
+static void BM_uniform_samples_exclude_min_into (benchmark::State& state)
+{
+  std::vector<double> buffer(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state)
+    {
+      uniform_samples_exclude_min_into(Interval(0, 1), buffer);
+      benchmark::DoNotOptimize(buffer.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_uniform_samples_exclude_min_into)->Range(1 << 4, 1 << 20);
+
+/// a 3 dimensional grid of about state.range(0) points, materialized in structure of arrays layout
+static void BM_grid_soa_into (benchmark::State& state)
+{
+  const auto samples = static_cast<std::size_t>(std::cbrt(static_cast<double>(state.range(0))));
+  const Grid<3> grid({Interval(0, 1), Interval(-1, 1), Interval(0, 10)}, {samples, samples, samples});
+
+  std::array<std::vector<double>, 3> coordinates;
+  for (auto& axis : coordinates)
+    axis.resize(grid.size());
+
+  for (auto _ : state)
+    {
+      grid.soa_into(0, grid.size(), {coordinates[0].data(), coordinates[1].data(), coordinates[2].data()});
+      benchmark::DoNotOptimize(coordinates[0].data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(grid.size()));
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(3 * grid.size() * sizeof(double)));
+}
+
+BENCHMARK(BM_grid_soa_into)->RangeMultiplier(1 << 6)->Range(1 << 12, 1 << 24);
@@ -0,0 +1,265 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include <boost/math/constants/constants.hpp>
+#include "wrap.hpp"
+#include "benchmark_sizes.hpp"
+
+using namespace PanosUtilities;
+
+namespace
+{
+    std::vector<double> make_angles (std::size_t size, double magnitude)
+    {
+      std::mt19937 generator(42);
+      std::uniform_real_distribution<double> distribution(-magnitude, magnitude);
+      std::vector<double> angles(size);
+      for (auto& angle : angles)
+        angle = distribution(generator);
+      return angles;
+    }
+
+    /// largest distance from an extended precision wrap, relative to the angle wrapped
+    double max_wrap_2pi_error (const std::vector<double>& angles, const std::vector<double>& wrapped)
+    {
+      const long double two_pi = boost::math::constants::two_pi<long double>();
+
+      double error = 0;
+      for (std::size_t i = 0; i < angles.size(); ++i)
+        {
+          const long double exact = angles[i] - two_pi * std::floor(angles[i] / two_pi);
+          const long double magnitude = std::max(std::abs(angles[i]), 1.0);
+          error = std::max(error, static_cast<double>(std::abs(wrapped[i] - exact) / magnitude));
+        }
+      return error;
+    }
+}
+
+static void BM_wrap_2pi_scalar_loop (benchmark::State& state)
+{
+  const auto angles = make_angles(static_cast<std::size_t>(state.range(0)), 1e3);
+  std::vector<double> wrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      std::transform(angles.cbegin(), angles.cend(), wrapped.begin(), [] (double angle)
+      { return wrap_2pi(angle); });
+      benchmark::DoNotOptimize(wrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["max_relative_error"] = max_wrap_2pi_error(angles, wrapped);
+}
+
+BENCHMARK(BM_wrap_2pi_scalar_loop)->Range(1 << 10, 1 << 22);
+
+static void BM_wrap_2pi_batch (benchmark::State& state)
+{
+  const auto angles = make_angles(static_cast<std::size_t>(state.range(0)), 1e3);
+  std::vector<double> wrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      wrap_2pi_batch(angles.data(), angles.data() + angles.size(), wrapped.data());
+      benchmark::DoNotOptimize(wrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(2 * sizeof(double)));
+  state.counters["max_relative_error"] = max_wrap_2pi_error(angles, wrapped);
+}
+
+BENCHMARK(BM_wrap_2pi_batch)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_wrap_2pi_batch)->Apply(size_decades);
+
+static void BM_wrap_minus_pi_pi_batch_inplace (benchmark::State& state)
+{
+  const auto angles = make_angles(static_cast<std::size_t>(state.range(0)), 1e3);
+  auto wrapped = angles;
+
+  for (auto _ : state)
+    {
+      wrap_minus_pi_pi_inplace(wrapped);
+      benchmark::DoNotOptimize(wrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_wrap_minus_pi_pi_batch_inplace)->Range(1 << 10, 1 << 22);
+
+static void BM_wrap_2pi_batch_float (benchmark::State& state)
+{
+  const auto angles = make_angles(static_cast<std::size_t>(state.range(0)), 1e3);
+  const std::vector<float> float_angles(angles.cbegin(), angles.cend());
+  std::vector<float> wrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      wrap_2pi_batch(float_angles.data(), float_angles.data() + float_angles.size(), wrapped.data());
+      benchmark::DoNotOptimize(wrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_wrap_2pi_batch_float)->Range(1 << 10, 1 << 22);
+
+/// angles that have drifted by less than a period out of [0, 2*pi), as after a small integration step
+static void BM_wrap_2pi_drifted (benchmark::State& state)
+{
+  auto angles = make_angles(static_cast<std::size_t>(state.range(0)), boost::math::double_constants::two_pi);
+  for (auto& angle : angles)
+    angle += boost::math::double_constants::pi;
+  std::vector<double> wrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      wrap_2pi_batch(angles.data(), angles.data() + angles.size(), wrapped.data());
+      benchmark::DoNotOptimize(wrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["max_relative_error"] = max_wrap_2pi_error(angles, wrapped);
+}
+
+BENCHMARK(BM_wrap_2pi_drifted)->Range(1 << 10, 1 << 22);
+
+static void BM_wrap_2pi_near_drifted (benchmark::State& state)
+{
+  auto angles = make_angles(static_cast<std::size_t>(state.range(0)), boost::math::double_constants::two_pi);
+  for (auto& angle : angles)
+    angle += boost::math::double_constants::pi;
+  std::vector<double> wrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      wrap_2pi_near_batch(angles.data(), angles.data() + angles.size(), wrapped.data());
+      benchmark::DoNotOptimize(wrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["max_relative_error"] = max_wrap_2pi_error(angles, wrapped);
+}
+
+BENCHMARK(BM_wrap_2pi_near_drifted)->Range(1 << 10, 1 << 22);
+
+static void BM_wrap_2pi_scalar_loop_drifted (benchmark::State& state)
+{
+  auto angles = make_angles(static_cast<std::size_t>(state.range(0)), boost::math::double_constants::two_pi);
+  for (auto& angle : angles)
+    angle += boost::math::double_constants::pi;
+  std::vector<double> wrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      std::transform(angles.cbegin(), angles.cend(), wrapped.begin(), [] (double angle)
+      { return wrap_2pi(angle); });
+      benchmark::DoNotOptimize(wrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_wrap_2pi_scalar_loop_drifted)->Range(1 << 10, 1 << 22);
+
+static void BM_wrap_2pi_near_scalar_loop_drifted (benchmark::State& state)
+{
+  auto angles = make_angles(static_cast<std::size_t>(state.range(0)), boost::math::double_constants::two_pi);
+  for (auto& angle : angles)
+    angle += boost::math::double_constants::pi;
+  std::vector<double> wrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      std::transform(angles.cbegin(), angles.cend(), wrapped.begin(), [] (double angle)
+      { return wrap_2pi_near(angle); });
+      benchmark::DoNotOptimize(wrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_wrap_2pi_near_scalar_loop_drifted)->Range(1 << 10, 1 << 22);
+
+namespace
+{
+    /// wrapped phase of a signal whose frequency drifts, about one wrap every 10 samples
+    std::vector<double> make_wrapped_phase (std::size_t size)
+    {
+      std::mt19937 generator(42);
+      std::uniform_real_distribution<double> step(0, 1.2);
+      std::vector<double> angles(size);
+      double phase = 0;
+      for (auto& angle : angles)
+        {
+          phase += step(generator);
+          angle = wrap_minus_pi_pi(phase);
+        }
+      return angles;
+    }
+}
+
+static void BM_unwrap_sequential (benchmark::State& state)
+{
+  const auto angles = make_wrapped_phase(static_cast<std::size_t>(state.range(0)));
+  std::vector<double> unwrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      unwrap(angles.cbegin(), angles.cend(), unwrapped.begin());
+      benchmark::DoNotOptimize(unwrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_unwrap_sequential)->Range(1 << 10, 1 << 22);
+
+static void BM_unwrap_batch (benchmark::State& state)
+{
+  const auto angles = make_wrapped_phase(static_cast<std::size_t>(state.range(0)));
+  std::vector<double> unwrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      unwrap_batch(angles.data(), angles.data() + angles.size(), unwrapped.data());
+      benchmark::DoNotOptimize(unwrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_unwrap_batch)->Range(1 << 10, 1 << 22);
+
+static void BM_unwrap_parallel (benchmark::State& state)
+{
+  const auto angles = make_wrapped_phase(1 << 24);
+  std::vector<double> unwrapped(angles.size());
+
+  for (auto _ : state)
+    {
+      unwrap_parallel(angles.data(), angles.data() + angles.size(), unwrapped.data(),
+                      static_cast<unsigned>(state.range(0)));
+      benchmark::DoNotOptimize(unwrapped.data());
+      benchmark::ClobberMemory();
+    }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(angles.size()));
+}
+
+BENCHMARK(BM_unwrap_parallel)->DenseRange(1, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)))
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
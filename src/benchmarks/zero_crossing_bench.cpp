@@ -0,0 +1,465 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/math/constants/constants.hpp>
+
+#include "zero_crossing.hpp"
+#include "interval.hpp"
+#include "benchmark_sizes.hpp"
+
+namespace
+{
+    /// a sine wave crossing zero every half_period samples
+    template<typename T>
+    std::vector<T> make_signal (std::size_t size, std::size_t half_period)
+    {
+      std::vector<T> signal(size);
+      for (std::size_t i = 0; i < size; ++i)
+        signal[i] = static_cast<T>(std::sin((static_cast<double>(i) + 0.5) * boost::math::double_constants::pi / static_cast<double>(half_period)));
+      return signal;
+    }
+
+    template<typename Container>
+    void run_zero_cross (benchmark::State& state, const Container& signal)
+    {
+      std::vector<typename Container::value_type> zeros;
+      zeros.reserve(signal.size());
+
+      for (auto _ : state)
+        {
+          zeros.clear();
+          PanosUtilities::zero_cross(signal.cbegin(), signal.cend(), std::back_inserter(zeros));
+          benchmark::DoNotOptimize(zeros.data());
+        }
+
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(signal.size()));
+      state.SetBytesProcessed(state.iterations()
+                              * static_cast<int64_t>(signal.size() * sizeof(typename Container::value_type)));
+    }
+
+    /// std::deque iterators take the generic single pass path
+    template<typename T>
+    void BM_zero_cross_single_pass (benchmark::State& state)
+    {
+      const auto signal = make_signal<T>(static_cast<std::size_t>(state.range(0)), 1000);
+      run_zero_cross(state, std::deque<T>(signal.cbegin(), signal.cend()));
+    }
+
+    template<typename T>
+    void BM_zero_cross_contiguous (benchmark::State& state)
+    {
+      run_zero_cross(state, make_signal<T>(static_cast<std::size_t>(state.range(0)), 1000));
+    }
+
+    void BM_zero_cross_parallel (benchmark::State& state)
+    {
+      static const auto signal = make_signal<double>(1 << 26, 1000);
+      const auto n_threads = static_cast<unsigned>(state.range(0));
+
+      std::vector<double> zeros;
+      zeros.reserve(signal.size());
+
+      for (auto _ : state)
+        {
+          zeros.clear();
+          PanosUtilities::zero_cross_parallel(signal.cbegin(), signal.cend(), std::back_inserter(zeros), n_threads);
+          benchmark::DoNotOptimize(zeros.data());
+        }
+
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(signal.size() * sizeof(double)));
+    }
+
+    /// the range overload as it used to be, taking the range by value
+    template<typename Range, typename OutputIterator>
+    void zero_cross_by_value (Range range, OutputIterator out)
+    {
+      PanosUtilities::zero_cross(std::cbegin(range), std::cend(range), out);
+    }
+
+    /// few crossings, so that the time is dominated by the scan, or by the copy of the range
+    void BM_zero_cross_range_by_value (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(static_cast<std::size_t>(state.range(0)), 100000);
+      std::vector<double> zeros;
+
+      for (auto _ : state)
+        {
+          zeros.clear();
+          zero_cross_by_value(signal, std::back_inserter(zeros));
+          benchmark::DoNotOptimize(zeros.data());
+        }
+
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(signal.size() * sizeof(double)));
+      state.counters["bytes_copied"] = static_cast<double>(signal.size() * sizeof(double));
+    }
+
+    void BM_zero_cross_range (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(static_cast<std::size_t>(state.range(0)), 100000);
+      std::vector<double> zeros;
+
+      for (auto _ : state)
+        {
+          zeros.clear();
+          PanosUtilities::zero_cross(signal, std::back_inserter(zeros));
+          benchmark::DoNotOptimize(zeros.data());
+        }
+
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(signal.size() * sizeof(double)));
+      state.counters["bytes_copied"] = 0;
+    }
+
+    /// a function with about 100 roots in [0, 100], cheap enough that the grid size dominates
+    double oscillation (double x)
+    {
+      return std::sin(x) + 0.5 * std::cos(3.1 * x);
+    }
+
+    const PanosUtilities::Interval oscillation_domain(0, 100);
+
+    double max_root_error (const std::vector<double>& roots)
+    {
+      static const auto reference = [] ()
+      {
+          std::vector<double> exact;
+          PanosUtilities::zero_cross_roots(PanosUtilities::uniform_samples(oscillation_domain, 1000),
+                                           std::back_inserter(exact), oscillation);
+          return exact;
+      }();
+
+      if (roots.size() != reference.size())
+        return std::numeric_limits<double>::infinity();
+
+      double error = 0;
+      for (std::size_t i = 0; i < roots.size(); ++i)
+        error = std::max(error, std::abs(roots[i] - reference[i]));
+      return error;
+    }
+
+    /// what refining replaces: sampling on a grid of state.range(0) points, fine enough for linear interpolation
+    void BM_roots_by_fine_sampling (benchmark::State& state)
+    {
+      std::vector<double> roots;
+
+      for (auto _ : state)
+        {
+          roots.clear();
+          const auto grid = PanosUtilities::uniform_samples(oscillation_domain, static_cast<std::size_t>(state.range(0)));
+          std::vector<double> values(grid.size());
+          std::transform(grid.cbegin(), grid.cend(), values.begin(), oscillation);
+          PanosUtilities::zero_cross_interpolated_abscissa(values.cbegin(), values.cend(), grid.cbegin(),
+                                                           std::back_inserter(roots));
+          benchmark::DoNotOptimize(roots.data());
+        }
+
+      state.counters["max_error"] = max_root_error(roots);
+    }
+
+    /// state.range(0) grid points, state.range(1) the tolerance as a negative power of 10, 0 for full precision
+    void BM_zero_cross_roots (benchmark::State& state)
+    {
+      const double tolerance = state.range(1) == 0 ? 0 : std::pow(10.0, -static_cast<double>(state.range(1)));
+      std::vector<double> roots;
+
+      for (auto _ : state)
+        {
+          roots.clear();
+          const auto grid = PanosUtilities::uniform_samples(oscillation_domain, static_cast<std::size_t>(state.range(0)));
+          PanosUtilities::zero_cross_roots(grid, std::back_inserter(roots), oscillation, tolerance);
+          benchmark::DoNotOptimize(roots.data());
+        }
+
+      state.counters["max_error"] = max_root_error(roots);
+    }
+
+    void BM_zero_cross_roots_parallel (benchmark::State& state)
+    {
+      const auto n_threads = static_cast<unsigned>(state.range(0));
+      std::vector<double> roots;
+
+      for (auto _ : state)
+        {
+          roots.clear();
+          const auto grid = PanosUtilities::uniform_samples(oscillation_domain, 1 << 14);
+          PanosUtilities::zero_cross_roots_parallel(grid.cbegin(), grid.cend(), std::back_inserter(roots), n_threads,
+                                                    oscillation);
+          benchmark::DoNotOptimize(roots.data());
+        }
+
+      state.counters["max_error"] = max_root_error(roots);
+    }
+
+    constexpr std::size_t n_channels = 8;
+    constexpr std::size_t channel_length = 1 << 18;
+
+    /// n_channels sine waves of different periods, each in its own vector
+    std::vector<std::vector<double>> make_channels ()
+    {
+      std::vector<std::vector<double>> channels;
+      for (std::size_t c = 0; c < n_channels; ++c)
+        channels.push_back(make_signal<double>(channel_length, 100 + 37 * c));
+      return channels;
+    }
+
+    void set_channel_counters (benchmark::State& state)
+    {
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n_channels * channel_length));
+      state.SetBytesProcessed(state.iterations()
+                              * static_cast<int64_t>(n_channels * channel_length * sizeof(double)));
+    }
+
+    /// what zero_cross_channels replaces: one pass per channel
+    void BM_zero_cross_channels_one_by_one (benchmark::State& state)
+    {
+      const auto channels = make_channels();
+      std::vector<std::vector<std::size_t>> indices(n_channels);
+
+      for (auto _ : state)
+        for (std::size_t c = 0; c < n_channels; ++c)
+          {
+            indices[c].clear();
+            PanosUtilities::ZeroCrossDetector<double>().push(channels[c], std::back_inserter(indices[c]));
+            benchmark::DoNotOptimize(indices[c].data());
+          }
+
+      set_channel_counters(state);
+    }
+
+    void BM_zero_cross_channels (benchmark::State& state)
+    {
+      const auto channels = make_channels();
+      std::vector<const double *> pointers;
+      for (const auto& channel : channels)
+        pointers.push_back(channel.data());
+
+      std::vector<PanosUtilities::ChannelCrossing> crossings;
+
+      for (auto _ : state)
+        {
+          crossings.clear();
+          PanosUtilities::zero_cross_channels(pointers.data(), n_channels, channel_length,
+                                              std::back_inserter(crossings));
+          benchmark::DoNotOptimize(crossings.data());
+        }
+
+      set_channel_counters(state);
+    }
+
+    /// what zero_cross_interleaved replaces: one pass per channel over the rows, projecting out the channel
+    void BM_zero_cross_interleaved_projected (benchmark::State& state)
+    {
+      const auto channels = make_channels();
+      std::vector<std::array<double, n_channels>> rows(channel_length);
+      for (std::size_t i = 0; i < channel_length; ++i)
+        for (std::size_t c = 0; c < n_channels; ++c)
+          rows[i][c] = channels[c][i];
+
+      std::vector<std::array<double, n_channels>> crossings;
+
+      for (auto _ : state)
+        {
+          crossings.clear();
+          for (std::size_t c = 0; c < n_channels; ++c)
+            PanosUtilities::zero_cross_transformed(rows.cbegin(), rows.cend(), std::back_inserter(crossings),
+                                                   [c] (const std::array<double, n_channels>& row)
+                                                   { return row[c]; });
+          benchmark::DoNotOptimize(crossings.data());
+        }
+
+      set_channel_counters(state);
+    }
+
+    void BM_zero_cross_interleaved (benchmark::State& state)
+    {
+      const auto channels = make_channels();
+      std::vector<double> interleaved(n_channels * channel_length);
+      for (std::size_t i = 0; i < channel_length; ++i)
+        for (std::size_t c = 0; c < n_channels; ++c)
+          interleaved[i * n_channels + c] = channels[c][i];
+
+      std::vector<PanosUtilities::ChannelCrossing> crossings;
+
+      for (auto _ : state)
+        {
+          crossings.clear();
+          PanosUtilities::zero_cross_interleaved(interleaved.data(), n_channels, channel_length,
+                                                 std::back_inserter(crossings));
+          benchmark::DoNotOptimize(crossings.data());
+        }
+
+      set_channel_counters(state);
+    }
+
+    constexpr std::size_t density_signal_size = 1 << 20;
+
+    /// state.range(0) is the number of samples between crossings
+    void BM_zero_cross_density (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(density_signal_size, static_cast<std::size_t>(state.range(0)));
+      run_zero_cross(state, signal);
+    }
+
+    void BM_zero_cross_max_distance (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(density_signal_size, static_cast<std::size_t>(state.range(0)));
+      const auto direction = static_cast<int>(state.range(1));
+
+      std::vector<double> zeros;
+      zeros.reserve(signal.size());
+
+      for (auto _ : state)
+        {
+          zeros.clear();
+          PanosUtilities::zero_cross(signal.cbegin(), signal.cend(), std::back_inserter(zeros), 0.5, direction);
+          benchmark::DoNotOptimize(zeros.data());
+        }
+
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(signal.size()));
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(signal.size() * sizeof(double)));
+    }
+
+    /// compare with BM_zero_cross_density and BM_zero_cross_max_distance, which write every crossing
+    /// state.range(1) selects the max_distance overload
+    void BM_count_zero_cross (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(density_signal_size, static_cast<std::size_t>(state.range(0)));
+      const bool limit_distance = state.range(1) != 0;
+
+      for (auto _ : state)
+        {
+          auto count = limit_distance ? PanosUtilities::count_zero_cross(signal, 0.5)
+                                      : PanosUtilities::count_zero_cross(signal);
+          benchmark::DoNotOptimize(count);
+        }
+
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(signal.size()));
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(signal.size() * sizeof(double)));
+    }
+
+    /// the first state.range(0) crossings of a signal crossing zero every 1000 samples
+    void BM_zero_cross_n (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(density_signal_size, 1000);
+      const auto n = static_cast<std::size_t>(state.range(0));
+
+      std::vector<double> zeros;
+      zeros.reserve(signal.size());
+
+      for (auto _ : state)
+        {
+          zeros.clear();
+          PanosUtilities::zero_cross_n(signal, std::back_inserter(zeros), n);
+          benchmark::DoNotOptimize(zeros.data());
+        }
+
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+    }
+
+    /// state.range(0) is the cost of the transform, in nested calls to std::sin, which keeps the sign of the signal
+    void BM_zero_cross_transformed_cost (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(density_signal_size, 1000);
+      const auto cost = state.range(0);
+
+      const auto transform = [cost] (double x)
+      {
+          for (int64_t i = 0; i < cost; ++i)
+            x = std::sin(x);
+          return x;
+      };
+
+      std::vector<double> zeros;
+      zeros.reserve(signal.size());
+
+      for (auto _ : state)
+        {
+          zeros.clear();
+          PanosUtilities::zero_cross_transformed(signal.cbegin(), signal.cend(), std::back_inserter(zeros), transform);
+          benchmark::DoNotOptimize(zeros.data());
+        }
+
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(signal.size()));
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(signal.size() * sizeof(double)));
+    }
+
+    void BM_zero_cross_interpolated (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(density_signal_size, static_cast<std::size_t>(state.range(0)));
+      const auto interpolation = static_cast<PanosUtilities::Interpolation>(state.range(1));
+
+      std::vector<double> zeros;
+      zeros.reserve(signal.size());
+
+      for (auto _ : state)
+        {
+          zeros.clear();
+          PanosUtilities::zero_cross_interpolated(signal.cbegin(), signal.cend(), std::back_inserter(zeros), 0,
+                                                  interpolation);
+          benchmark::DoNotOptimize(zeros.data());
+        }
+
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(signal.size()));
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(signal.size() * sizeof(double)));
+    }
+
+    /// the signal pushed in blocks of state.range(0) samples, as when it arrives from a stream
+    void BM_zero_cross_detector (benchmark::State& state)
+    {
+      const auto signal = make_signal<double>(density_signal_size, 1000);
+      const auto block_size = static_cast<std::size_t>(state.range(0));
+
+      std::vector<std::size_t> indices;
+      indices.reserve(signal.size());
+
+      for (auto _ : state)
+        {
+          indices.clear();
+          PanosUtilities::ZeroCrossDetector<double> detector;
+          for (std::size_t i = 0; i < signal.size(); i += block_size)
+            detector.push(signal.cbegin() + static_cast<std::ptrdiff_t>(i),
+                          signal.cbegin() + static_cast<std::ptrdiff_t>(std::min(i + block_size, signal.size())),
+                          std::back_inserter(indices));
+          benchmark::DoNotOptimize(indices.data());
+        }
+
+      state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(signal.size()));
+      state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(signal.size() * sizeof(double)));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_zero_cross_single_pass, double)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(BM_zero_cross_contiguous, double)->Apply(size_decades);
+BENCHMARK_TEMPLATE(BM_zero_cross_single_pass, float)->Range(1 << 10, 1 << 24);
+BENCHMARK_TEMPLATE(BM_zero_cross_contiguous, float)->Range(1 << 10, 1 << 24);
+BENCHMARK(BM_zero_cross_parallel)
+    ->DenseRange(1, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_zero_cross_range_by_value)->Apply(size_decades);
+BENCHMARK(BM_zero_cross_range)->Apply(size_decades);
+BENCHMARK(BM_roots_by_fine_sampling)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_zero_cross_roots)->ArgsProduct({{1000, 3000}, {0, 6, 9}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_zero_cross_roots_parallel)
+    ->DenseRange(1, static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u)))
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_zero_cross_channels_one_by_one);
+BENCHMARK(BM_zero_cross_channels);
+BENCHMARK(BM_zero_cross_interleaved_projected);
+BENCHMARK(BM_zero_cross_interleaved);
+BENCHMARK(BM_zero_cross_density)->RangeMultiplier(10)->Range(2, 200000);
+BENCHMARK(BM_zero_cross_max_distance)->ArgsProduct({{2, 1000}, {-1, 0, 1}});
+BENCHMARK(BM_count_zero_cross)->ArgsProduct({{2, 1000, 200000}, {0, 1}});
+BENCHMARK(BM_zero_cross_n)->RangeMultiplier(10)->Range(1, 1000);
+BENCHMARK(BM_zero_cross_transformed_cost)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_zero_cross_interpolated)->ArgsProduct({{2, 1000},
+                                                    {static_cast<int64_t>(PanosUtilities::Interpolation::linear),
+                                                     static_cast<int64_t>(PanosUtilities::Interpolation::cubic)}});
+BENCHMARK(BM_zero_cross_detector)->RangeMultiplier(16)->Range(64, 1 << 20);
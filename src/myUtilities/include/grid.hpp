@@ -0,0 +1,192 @@
+#ifndef MYUTILITIES_GRID_HPP
+#define MYUTILITIES_GRID_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "interval.hpp"
+
+namespace PanosUtilities
+{
+
+    /// \brief tensor product of uniform samples of N intervals
+    /// \tparam N number of dimensions
+    ///
+    /// Grid points are numbered in row-major order, i.e. the last axis varies fastest,
+    /// as in N nested loops over uniform_samples with axis 0 outermost.
+    /// Only the samples of each axis are stored, points are computed on demand.
+    template<std::size_t N>
+    class Grid {
+      static_assert(N > 0, "Grid: number of dimensions must be positive");
+
+      std::array<std::vector<double>, N> axes_;
+      std::size_t size_{1};
+
+     public:
+      using Point = std::array<double, N>;
+      using MultiIndex = std::array<std::size_t, N>;
+
+      /// \brief a range [first, last) of grid point indices
+      using IndexRange = std::pair<std::size_t, std::size_t>;
+
+      /// \param intervals the interval spanned by each axis
+      /// \param samples number of uniform samples of each axis
+      /// throws std::domain_error if any axis has less than 2 samples
+      Grid (const std::array<Interval, N>& intervals, const MultiIndex& samples)
+      {
+        for (std::size_t d = 0; d < N; ++d)
+          {
+            axes_[d] = uniform_samples(intervals[d], samples[d]);
+            size_ *= samples[d];
+          }
+      }
+
+      /// \brief total number of grid points
+      std::size_t size () const noexcept
+      { return size_; }
+
+      /// \brief number of samples of each axis
+      MultiIndex shape () const noexcept
+      {
+        MultiIndex result{};
+        for (std::size_t d = 0; d < N; ++d)
+          result[d] = axes_[d].size();
+        return result;
+      }
+
+      /// \brief samples of axis d, identical to uniform_samples of its interval
+      const std::vector<double>& axis (std::size_t d) const noexcept
+      { return axes_[d]; }
+
+      MultiIndex multi_index (std::size_t index) const noexcept
+      {
+        MultiIndex result{};
+        for (std::size_t d = N; d-- > 0;)
+          {
+            result[d] = index % axes_[d].size();
+            index /= axes_[d].size();
+          }
+        return result;
+      }
+
+      Point point (const MultiIndex& multi_index) const noexcept
+      {
+        Point result{};
+        for (std::size_t d = 0; d < N; ++d)
+          result[d] = axes_[d][multi_index[d]];
+        return result;
+      }
+
+      /// \brief the grid point with the given index
+      Point operator[] (std::size_t index) const noexcept
+      { return point(multi_index(index)); }
+
+      /// \brief splits the grid points in n_chunks contiguous ranges of nearly equal size
+      ///
+      /// The ranges are meant to be handed to different threads, see for_each_point and the *_into functions.
+      std::vector<IndexRange> chunks (std::size_t n_chunks) const
+      {
+        n_chunks = std::max<std::size_t>(1, std::min(n_chunks, size_));
+
+        std::vector<IndexRange> result;
+        result.reserve(n_chunks);
+
+        const std::size_t base = size_ / n_chunks;
+        const std::size_t remainder = size_ % n_chunks;
+
+        std::size_t first = 0;
+        for (std::size_t i = 0; i < n_chunks; ++i)
+          {
+            const std::size_t last = first + base + (i < remainder ? 1 : 0);
+            result.emplace_back(first, last);
+            first = last;
+          }
+        return result;
+      }
+
+      /// \brief calls f(index, point) for every grid point with index in [first, last)
+      ///
+      /// The multi-index is advanced incrementally, so there is a single division per call, not per point.
+      template<typename Function>
+      void for_each_point (std::size_t first, std::size_t last, Function f) const
+      {
+        if (first >= last)
+          return;
+
+        auto mi = multi_index(first);
+        auto p = point(mi);
+
+        for (std::size_t index = first;;)
+          {
+            f(index, std::as_const(p));
+
+            if (++index == last)
+              return;
+
+            for (std::size_t d = N; d-- > 0;)
+              {
+                if (++mi[d] < axes_[d].size())
+                  {
+                    p[d] = axes_[d][mi[d]];
+                    break;
+                  }
+                mi[d] = 0;
+                p[d] = axes_[d][0];
+              }
+          }
+      }
+
+      template<typename Function>
+      void for_each_point (const IndexRange& range, Function f) const
+      { for_each_point(range.first, range.second, f); }
+
+      template<typename Function>
+      void for_each_point (Function f) const
+      { for_each_point(0, size_, f); }
+
+      /// \brief writes the coordinates of the points in [first, last) in structure of arrays layout
+      /// \param outputs outputs[d] receives last - first coordinates along axis d
+      void soa_into (std::size_t first, std::size_t last, const std::array<double *, N>& outputs) const
+      {
+        for_each_point(first, last, [&] (std::size_t index, const Point& p)
+        {
+          for (std::size_t d = 0; d < N; ++d)
+            outputs[d][index - first] = p[d];
+        });
+      }
+
+      /// \brief writes the points in [first, last) in array of structures layout
+      /// \param output receives last - first points, i.e. N * (last - first) interleaved coordinates
+      void aos_into (std::size_t first, std::size_t last, Point *output) const
+      {
+        for_each_point(first, last, [&] (std::size_t index, const Point& p)
+        { output[index - first] = p; });
+      }
+
+      /// \brief coordinates of all the grid points, one vector per axis
+      std::array<std::vector<double>, N> soa () const
+      {
+        std::array<std::vector<double>, N> result;
+        std::array<double *, N> outputs{};
+        for (std::size_t d = 0; d < N; ++d)
+          {
+            result[d].resize(size_);
+            outputs[d] = result[d].data();
+          }
+        soa_into(0, size_, outputs);
+        return result;
+      }
+
+      /// \brief all the grid points, in one contiguous vector
+      std::vector<Point> aos () const
+      {
+        std::vector<Point> result(size_);
+        aos_into(0, size_, result.data());
+        return result;
+      }
+    };
+
+}
+#endif //MYUTILITIES_GRID_HPP
@@ -5,27 +5,171 @@
 #ifndef MYUTILITIES_INTERVAL_HPP
 #define MYUTILITIES_INTERVAL_HPP
 #include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include "linspace.hpp"
 
 namespace PanosUtilities
 {
 
-    class Interval {
-      double min_{0};
-      double max_{0};
+    /// \brief closed interval [min, max]
+    /// \tparam T floating point type of the bounds, one of float, double and long double
+    template<typename T>
+    class BasicInterval {
+      static_assert(std::is_floating_point_v<T>, "BasicInterval: T must be a floating point type");
+
+      T min_{0};
+      T max_{0};
      public:
-      Interval (double a, double b) noexcept;
-      double min () const noexcept;
-      double max () const noexcept;
+      using value_type = T;
+
+      /// same as std::minmax(a, b), which can not be assigned to the members in a constexpr constructor
+      constexpr BasicInterval (T a, T b) noexcept
+          : min_{b < a ? b : a}, max_{b < a ? a : b}
+      {}
+
+      constexpr T min () const noexcept
+      { return min_; }
+
+      constexpr T max () const noexcept
+      { return max_; }
     };
 
-    bool is_inside (double x, const Interval& interval);
+    using Interval = BasicInterval<double>;
+
+    ///defined in the header, like the members of BasicInterval, so that it is inlined in tight loops
+    template<typename T>
+    constexpr bool is_inside (typename BasicInterval<T>::value_type x, const BasicInterval<T>& interval) noexcept
+    {
+      return (x >= interval.min() && x <= interval.max());
+    }
+
+    ///\brief the point of interval closest to x, like std::clamp(x, interval.min(), interval.max())
+    template<typename T>
+    constexpr T clamp (typename BasicInterval<T>::value_type x, const BasicInterval<T>& interval) noexcept
+    {
+      return x < interval.min() ? interval.min() : (interval.max() < x ? interval.max() : x);
+    }
+
+    ///\brief number of 64 bit words of the mask written by is_inside_batch for size points
+    constexpr std::size_t is_inside_mask_size (std::size_t size) noexcept
+    {
+      return (size + 63) / 64;
+    }
+
+    ///\brief sets bit i % 64 of mask[i / 64] if first[i] is inside interval, and clears it otherwise
+    ///\param mask receives is_inside_mask_size(last - first) words, the unused bits of the last word are cleared
+    ///
+    ///The batch functions are vectorized and, like wrap_2pi_batch, exist only for double and float.
+    void is_inside_batch (const Interval& interval, const double *first, const double *last,
+                          std::uint64_t *mask) noexcept;
+
+    void is_inside_batch (const BasicInterval<float>& interval, const float *first, const float *last,
+                          std::uint64_t *mask) noexcept;
+
+    ///\brief number of points in [first, last) inside interval
+    std::size_t count_inside (const Interval& interval, const double *first, const double *last) noexcept;
+
+    std::size_t count_inside (const BasicInterval<float>& interval, const float *first, const float *last) noexcept;
+
+    ///\brief applies clamp to each point in [first, last), writing the results to d_first, which may be equal to first
+    void clamp_batch (const Interval& interval, const double *first, const double *last, double *d_first) noexcept;
+
+    void clamp_batch (const BasicInterval<float>& interval, const float *first, const float *last,
+                      float *d_first) noexcept;
 
-    std::vector<double> uniform_samples (const Interval& interval, size_t numOfsamples);
+    ///\brief reorders [first, last) so that the points inside interval come before the rest
+    ///\return pointer to the first point not inside interval
+    ///
+    ///Like std::partition, the relative order of the points is not preserved.
+    ///The points are classified in blocks without branches, so the speed does not depend on how they are mixed.
+    double *partition_inside (const Interval& interval, double *first, double *last) noexcept;
+
+    float *partition_inside (const BasicInterval<float>& interval, float *first, float *last) noexcept;
+
+    ///\brief is_inside_batch of a contiguous container (e.g. std::vector or std::array) of doubles or floats
+    template<typename T, typename ContiguousRange>
+    std::vector<std::uint64_t> is_inside_batch (const BasicInterval<T>& interval, const ContiguousRange& points)
+    {
+      std::vector<std::uint64_t> mask(is_inside_mask_size(std::size(points)));
+      is_inside_batch(interval, std::data(points), std::data(points) + std::size(points), mask.data());
+      return mask;
+    }
+
+    template<typename T, typename ContiguousRange>
+    std::size_t count_inside (const BasicInterval<T>& interval, const ContiguousRange& points) noexcept
+    {
+      return count_inside(interval, std::data(points), std::data(points) + std::size(points));
+    }
+
+    template<typename T, typename ContiguousRange>
+    void clamp_inplace (const BasicInterval<T>& interval, ContiguousRange& points) noexcept
+    {
+      clamp_batch(interval, std::data(points), std::data(points) + std::size(points), std::data(points));
+    }
+
+    ///\return the number of points inside interval, which are now the first ones
+    template<typename T, typename ContiguousRange>
+    std::size_t partition_inside (const BasicInterval<T>& interval, ContiguousRange& points) noexcept
+    {
+      const auto first = std::data(points);
+      return static_cast<std::size_t>(partition_inside(interval, first, first + std::size(points)) - first);
+    }
+
+    template<typename T>
+    std::vector<T> uniform_samples (const BasicInterval<T>& interval, size_t numOfsamples);
 
     ///This is equivalent to creating uniform samples of numOfsamples + 1 samples and deleting the first sample
-    std::vector<double> uniform_samples_exclude_min (const Interval& interval, size_t numOfsamples);
+    template<typename T>
+    std::vector<T> uniform_samples_exclude_min (const BasicInterval<T>& interval, size_t numOfsamples);
 
     ///This is equivalent to creating uniform samples of numOfsamples + 1 samples and deleting the last sample
-    std::vector<double> uniform_samples_exclude_max (const Interval& interval, size_t numOfsamples);
+    template<typename T>
+    std::vector<T> uniform_samples_exclude_max (const BasicInterval<T>& interval, size_t numOfsamples);
+
+    ///\brief fills [first, last) with uniform samples of interval, see basic_linspace_into
+    template<typename T>
+    void uniform_samples_into (const BasicInterval<T>& interval, T *first, T *last);
+
+    ///\brief fills [first, last) with the samples of uniform_samples_exclude_min, without allocating
+    ///
+    ///The last sample is exactly interval.max()
+    ///throws std::domain_error if [first, last) holds less than 2 elements, like uniform_samples_exclude_min
+    template<typename T>
+    void uniform_samples_exclude_min_into (const BasicInterval<T>& interval, T *first, T *last);
+
+    ///\brief fills [first, last) with the samples of uniform_samples_exclude_max, without allocating
+    ///
+    ///The first sample is exactly interval.min()
+    ///throws std::domain_error if [first, last) holds less than 2 elements, like uniform_samples_exclude_max
+    template<typename T>
+    void uniform_samples_exclude_max_into (const BasicInterval<T>& interval, T *first, T *last);
+
+    template<typename T, typename ContiguousRange>
+    void uniform_samples_into (const BasicInterval<T>& interval, ContiguousRange& output)
+    {
+      uniform_samples_into(interval, std::data(output), std::data(output) + std::size(output));
+    }
+
+    template<typename T, typename ContiguousRange>
+    void uniform_samples_exclude_min_into (const BasicInterval<T>& interval, ContiguousRange& output)
+    {
+      uniform_samples_exclude_min_into(interval, std::data(output), std::data(output) + std::size(output));
+    }
+
+    template<typename T, typename ContiguousRange>
+    void uniform_samples_exclude_max_into (const BasicInterval<T>& interval, ContiguousRange& output)
+    {
+      uniform_samples_exclude_max_into(interval, std::data(output), std::data(output) + std::size(output));
+    }
+
+    ///lazy equivalent of uniform_samples, see BasicLinspaceView
+    template<typename T>
+    BasicLinspaceView<T> uniform_samples_view (const BasicInterval<T>& interval, size_t numOfsamples)
+    {
+      return basic_linspace_view(interval.min(), interval.max(), numOfsamples);
+    }
 }
 #endif //MYUTILITIES_INTERVAL_HPP
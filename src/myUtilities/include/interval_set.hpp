@@ -0,0 +1,82 @@
+#ifndef MYUTILITIES_INTERVAL_SET_HPP
+#define MYUTILITIES_INTERVAL_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "interval.hpp"
+
+namespace PanosUtilities
+{
+
+    /// \brief union of closed intervals, for membership queries against many intervals at once
+    /// \tparam T floating point type of the bounds, one of float, double and long double
+    ///
+    /// Overlapping and touching intervals are merged on construction.
+    /// The bounds of the remaining disjoint intervals are kept sorted in two flat arrays,
+    /// so that a query is a binary search in O(log M) for M intervals, instead of M calls to is_inside.
+    template<typename T>
+    class BasicIntervalSet {
+      std::vector<T> mins_;
+      std::vector<T> maxs_;
+
+     public:
+      using value_type = T;
+
+      BasicIntervalSet () = default;
+
+      explicit BasicIntervalSet (const std::vector<BasicInterval<T>>& intervals);
+
+      template<typename InputIt>
+      BasicIntervalSet (InputIt first, InputIt last)
+          : BasicIntervalSet(std::vector<BasicInterval<T>>(first, last))
+      {}
+
+      /// \brief number of disjoint intervals, after merging
+      std::size_t size () const noexcept
+      { return mins_.size(); }
+
+      bool empty () const noexcept
+      { return mins_.empty(); }
+
+      /// \brief the i-th disjoint interval, in increasing order
+      BasicInterval<T> operator[] (std::size_t i) const noexcept
+      { return BasicInterval<T>(mins_[i], maxs_[i]); }
+
+      bool contains (T x) const noexcept;
+
+      /// \brief index of the interval containing x, or size() if there is none
+      std::size_t find (T x) const noexcept;
+
+      /// \brief sets bit i % 64 of mask[i / 64] if first[i] is in the set, and clears it otherwise
+      /// \param mask receives is_inside_mask_size(last - first) words, as in is_inside_batch
+      ///
+      /// The points may be in any order. They are searched for in blocks,
+      /// with the steps of the binary searches interleaved, so that their memory accesses overlap.
+      void contains_batch (const T *first, const T *last, std::uint64_t *mask) const noexcept;
+
+      /// \brief same as contains_batch, for points sorted in increasing order
+      ///
+      /// The points and the intervals are merged in a single pass, in O(N + M) for N points.
+      void contains_sorted_batch (const T *first, const T *last, std::uint64_t *mask) const noexcept;
+    };
+
+    using IntervalSet = BasicIntervalSet<double>;
+
+    template<typename T>
+    bool is_inside (typename BasicIntervalSet<T>::value_type x, const BasicIntervalSet<T>& set) noexcept
+    {
+      return set.contains(x);
+    }
+
+    ///\brief contains_batch of a contiguous container (e.g. std::vector or std::array) of points
+    template<typename T, typename ContiguousRange>
+    std::vector<std::uint64_t> is_inside_batch (const BasicIntervalSet<T>& set, const ContiguousRange& points)
+    {
+      std::vector<std::uint64_t> mask(is_inside_mask_size(std::size(points)));
+      set.contains_batch(std::data(points), std::data(points) + std::size(points), mask.data());
+      return mask;
+    }
+}
+#endif //MYUTILITIES_INTERVAL_SET_HPP
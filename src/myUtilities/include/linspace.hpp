@@ -6,11 +6,195 @@
 #define MYUTILITIES_LINSPACE_HPP
 
 #include <vector>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
 
 namespace PanosUtilities
 {
+    /// \brief numOfsamples uniform samples from begin to end, both included
+    /// \tparam T floating point type of the samples, one of float, double and long double
+    ///
+    /// throws std::domain_error if numOfsamples is less than 2
+    template<typename T>
+    std::vector<T> basic_linspace (T begin, T end, size_t numOfsamples);
+
     std::vector<double> linspace (double begin, double end, size_t numOfsamples);
 
+    /// \brief fills [first, last) with last - first uniform samples from begin to end, without allocating
+    /// \tparam T one of float, double and long double
+    ///
+    /// Values are begin + i * step, with the step computed once, and the last sample set to end,
+    /// so they may differ from those of basic_linspace in the last bit.
+    /// throws std::domain_error if [first, last) holds less than 2 elements
+    template<typename T>
+    void basic_linspace_into (T begin, T end, T *first, T *last);
+
+    /// \brief double version of basic_linspace_into
+    void linspace_into (double begin, double end, double *first, double *last);
+
+    /// \brief fills a contiguous container of floating point values (e.g. std::vector or std::array) like basic_linspace_into
+    template<typename ContiguousRange>
+    void linspace_into (double begin, double end, ContiguousRange& output)
+    {
+      using T = std::remove_pointer_t<decltype(std::data(output))>;
+      basic_linspace_into(static_cast<T>(begin), static_cast<T>(end), std::data(output), std::data(output) + std::size(output));
+    }
+
+
+    /// \brief lazy equivalent of basic_linspace
+    /// \tparam T floating point type of the samples
+    ///
+    /// Elements are computed on demand, with the same formula as basic_linspace, so both give identical values.
+    /// The view holds no memory and its iterators are random access.
+    template<typename T>
+    class BasicLinspaceView {
+      static_assert(std::is_floating_point_v<T>, "BasicLinspaceView: T must be a floating point type");
+
+      T begin_{0};
+      T distance_{0};
+      std::size_t size_{0};
+
+     public:
+      class iterator {
+        T begin_{0};
+        T distance_{0};
+        T intervals_{1};
+        std::ptrdiff_t index_{0};
+
+       public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        constexpr iterator () noexcept = default;
+
+        constexpr iterator (T begin, T distance, std::size_t size, std::ptrdiff_t index) noexcept
+            : begin_{begin}, distance_{distance}, intervals_{static_cast<T>(size - 1)}, index_{index}
+        {}
+
+        constexpr T operator* () const noexcept
+        { return begin_ + static_cast<T>(index_) * distance_ / intervals_; }
+
+        constexpr T operator[] (difference_type n) const noexcept
+        { return *(*this + n); }
+
+        constexpr iterator& operator++ () noexcept
+        {
+          ++index_;
+          return *this;
+        }
+
+        constexpr iterator operator++ (int) noexcept
+        {
+          auto copy = *this;
+          ++index_;
+          return copy;
+        }
+
+        constexpr iterator& operator-- () noexcept
+        {
+          --index_;
+          return *this;
+        }
+
+        constexpr iterator operator-- (int) noexcept
+        {
+          auto copy = *this;
+          --index_;
+          return copy;
+        }
+
+        constexpr iterator& operator+= (difference_type n) noexcept
+        {
+          index_ += n;
+          return *this;
+        }
+
+        constexpr iterator& operator-= (difference_type n) noexcept
+        {
+          index_ -= n;
+          return *this;
+        }
+
+        friend constexpr iterator operator+ (iterator it, difference_type n) noexcept
+        { return it += n; }
+
+        friend constexpr iterator operator+ (difference_type n, iterator it) noexcept
+        { return it += n; }
+
+        friend constexpr iterator operator- (iterator it, difference_type n) noexcept
+        { return it -= n; }
+
+        friend constexpr difference_type operator- (const iterator& a, const iterator& b) noexcept
+        { return a.index_ - b.index_; }
+
+        friend constexpr bool operator== (const iterator& a, const iterator& b) noexcept
+        { return a.index_ == b.index_; }
+
+        friend constexpr bool operator!= (const iterator& a, const iterator& b) noexcept
+        { return a.index_ != b.index_; }
+
+        friend constexpr bool operator< (const iterator& a, const iterator& b) noexcept
+        { return a.index_ < b.index_; }
+
+        friend constexpr bool operator> (const iterator& a, const iterator& b) noexcept
+        { return a.index_ > b.index_; }
+
+        friend constexpr bool operator<= (const iterator& a, const iterator& b) noexcept
+        { return a.index_ <= b.index_; }
+
+        friend constexpr bool operator>= (const iterator& a, const iterator& b) noexcept
+        { return a.index_ >= b.index_; }
+      };
+
+      using const_iterator = iterator;
+      using value_type = T;
+      using size_type = std::size_t;
+
+      /// throws std::domain_error if numOfsamples is less than 2, like linspace
+      constexpr BasicLinspaceView (T begin, T end, std::size_t numOfsamples)
+          : begin_{begin}, distance_{end - begin}, size_{numOfsamples}
+      {
+        if (numOfsamples < 2)
+          throw std::domain_error("linspace_view: number of samples must be greater than 1");
+      }
+
+      constexpr iterator begin () const noexcept
+      { return iterator(begin_, distance_, size_, 0); }
+
+      constexpr iterator end () const noexcept
+      { return iterator(begin_, distance_, size_, static_cast<std::ptrdiff_t>(size_)); }
+
+      constexpr std::size_t size () const noexcept
+      { return size_; }
+
+      constexpr T operator[] (std::size_t i) const noexcept
+      { return begin()[static_cast<std::ptrdiff_t>(i)]; }
+
+      constexpr T front () const noexcept
+      { return (*this)[0]; }
+
+      constexpr T back () const noexcept
+      { return (*this)[size_ - 1]; }
+    };
+
+    using LinspaceView = BasicLinspaceView<double>;
+
+    template<typename T>
+    constexpr BasicLinspaceView<T> basic_linspace_view (T begin, T end, size_t numOfsamples)
+    {
+      return BasicLinspaceView<T>(begin, end, numOfsamples);
+    }
+
+    constexpr LinspaceView linspace_view (double begin, double end, size_t numOfsamples)
+    {
+      return LinspaceView(begin, end, numOfsamples);
+    }
+
 }
 
 
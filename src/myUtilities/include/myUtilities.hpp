@@ -4,6 +4,8 @@
 
 #include "linspace.hpp"
 #include "interval.hpp"
+#include "interval_set.hpp"
+#include "grid.hpp"
 #include "wrap.hpp"
 #include "zero_crossing.hpp"
 #include "data_reading.hpp"
@@ -4,23 +4,260 @@
 
 #ifndef MYUTILITIES_WRAP_HPP
 #define MYUTILITIES_WRAP_HPP
+
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+#include <boost/math/constants/constants.hpp>
+
 namespace PanosUtilities
 {
 
 
+    /// \brief basic_wrap_2pi maps angle on the range [0,2*pi) substracting any integer multiples of 2*pi
+    /// \tparam T floating point type of the angle
+    /// \param angle
+    /// \return an equivalent angle in [0,2*pi)
+    ///
+    /// relative error about the machine epsilon of T, e.g. 1e-16 for double and 1e-7 for float
+    template<typename T>
+    inline T basic_wrap_2pi (T angle) noexcept
+    {
+      static_assert(std::is_floating_point_v<T>, "basic_wrap_2pi: T must be a floating point type");
+
+      using boost::math::constants::one_div_two_pi;
+      using boost::math::constants::two_pi;
+
+      return angle - two_pi<T>() * std::floor(angle * one_div_two_pi<T>());
+    }
+
+    /// \brief basic_wrap_minus_pi_pi maps angle on the range [-pi,pi)
+    /// \tparam T floating point type of the angle
+    /// \param angle
+    /// \return an equivalent angle in [-pi,pi)
+    ///
+    /// relative error about the machine epsilon of T, e.g. 1e-16 for double and 1e-7 for float
+    template<typename T>
+    inline T basic_wrap_minus_pi_pi (T angle) noexcept
+    {
+      using boost::math::constants::pi;
+
+      return basic_wrap_2pi(angle + pi<T>()) - pi<T>();
+    }
+
     /// \brief wrap2_pi maps angle on the range [0,2*pi) substracting any integer multiples of 2*pi
     /// \param angle
     /// \return an equivalent angle in [0,2*pi)
     ///
     /// relative error about 1e-16
-    double wrap_2pi (double angle) noexcept;
+    inline double wrap_2pi (double angle) noexcept
+    {
+      return basic_wrap_2pi(angle);
+    }
 
     /// \brief wrap_minus_pi_pi maps angle on the range [-pi,pi)
     /// \param angle
     /// \return an equivalent angle in [-pi,pi)
     ///
     /// relative error about 1e-16
-    double wrap_minus_pi_pi (double angle) noexcept;
+    inline double wrap_minus_pi_pi (double angle) noexcept
+    {
+      return basic_wrap_minus_pi_pi(angle);
+    }
+
+    /// \brief basic_wrap_2pi_near maps on [0,2*pi) an angle less than Periods periods outside of it
+    /// \tparam Periods how far outside [0,2*pi) the angle may be, in periods
+    /// \param angle in [-Periods*2*pi, (Periods+1)*2*pi), otherwise it is only partially wrapped
+    /// \return an equivalent angle in [0,2*pi)
+    ///
+    /// Adds or subtracts 2*pi conditionally, once per period, with no multiplication, floor or branch.
+    /// Cheaper than basic_wrap_2pi for small Periods, e.g. for angles advanced by a small step,
+    /// most of all on processors without a vector floor instruction (before SSE4.1).
+    /// The absolute error is at most Periods * (Periods + 1) * 2*pi * epsilon of T, i.e. 2.8e-15 for double
+    /// and 1.5e-6 for float when Periods is 1.
+    template<int Periods = 1, typename T>
+    inline T basic_wrap_2pi_near (T angle) noexcept
+    {
+      static_assert(std::is_floating_point_v<T>, "basic_wrap_2pi_near: T must be a floating point type");
+      static_assert(Periods > 0, "basic_wrap_2pi_near: Periods must be positive");
+
+      constexpr T two_pi = boost::math::constants::two_pi<T>();
+
+      //this is the scalar, inlined path: converting the comparisons to int keeps a single angle free of branches.
+      //The batch functions use selects of T instead, which is the form the compiler vectorizes, see wrap.cpp
+      for (int i = 0; i < Periods; ++i)
+        {
+          const int below = angle < 0;
+          angle += two_pi * static_cast<T>(below);
+          const int above = angle >= two_pi;
+          angle -= two_pi * static_cast<T>(above);
+        }
+      return angle;
+    }
+
+    /// \brief basic_wrap_minus_pi_pi_near maps on [-pi,pi) an angle less than Periods periods outside of it
+    /// \tparam Periods how far outside [-pi,pi) the angle may be, in periods
+    /// \param angle in [-pi-Periods*2*pi, pi+Periods*2*pi), otherwise it is only partially wrapped
+    /// \return an equivalent angle in [-pi,pi)
+    ///
+    /// Same method and error bound as basic_wrap_2pi_near.
+    template<int Periods = 1, typename T>
+    inline T basic_wrap_minus_pi_pi_near (T angle) noexcept
+    {
+      static_assert(std::is_floating_point_v<T>, "basic_wrap_minus_pi_pi_near: T must be a floating point type");
+      static_assert(Periods > 0, "basic_wrap_minus_pi_pi_near: Periods must be positive");
+
+      constexpr T pi = boost::math::constants::pi<T>();
+      constexpr T two_pi = boost::math::constants::two_pi<T>();
+
+      for (int i = 0; i < Periods; ++i)
+        {
+          const int below = angle < -pi;
+          angle += two_pi * static_cast<T>(below);
+          const int above = angle >= pi;
+          angle -= two_pi * static_cast<T>(above);
+        }
+      return angle;
+    }
+
+    /// \brief double version of basic_wrap_2pi_near
+    template<int Periods = 1>
+    inline double wrap_2pi_near (double angle) noexcept
+    {
+      return basic_wrap_2pi_near<Periods>(angle);
+    }
+
+    /// \brief double version of basic_wrap_minus_pi_pi_near
+    template<int Periods = 1>
+    inline double wrap_minus_pi_pi_near (double angle) noexcept
+    {
+      return basic_wrap_minus_pi_pi_near<Periods>(angle);
+    }
+
+    /// \brief applies wrap_2pi to each angle in [first, last), writing the results to d_first
+    ///
+    /// Vectorized where the processor allows it, with the same error as the scalar version.
+    /// d_first may be equal to first.
+    /// The batch functions have their own names, so that wrap_2pi can still be passed as a function.
+    void wrap_2pi_batch (const double *first, const double *last, double *d_first) noexcept;
+
+    /// \brief applies basic_wrap_2pi<float> to each angle in [first, last), writing the results to d_first
+    void wrap_2pi_batch (const float *first, const float *last, float *d_first) noexcept;
+
+    /// \brief applies wrap_minus_pi_pi to each angle in [first, last), writing the results to d_first, see wrap_2pi_batch
+    void wrap_minus_pi_pi_batch (const double *first, const double *last, double *d_first) noexcept;
+
+    /// \brief applies basic_wrap_minus_pi_pi<float> to each angle in [first, last), writing the results to d_first
+    void wrap_minus_pi_pi_batch (const float *first, const float *last, float *d_first) noexcept;
+
+    /// \brief applies wrap_2pi_near to each angle in [first, last), writing the results to d_first
+    /// \param max_periods how far outside [0,2*pi) the angles may be, in periods, see basic_wrap_2pi_near
+    ///
+    /// Vectorized where the processor allows it. d_first may be equal to first.
+    void wrap_2pi_near_batch (const double *first, const double *last, double *d_first, int max_periods = 1) noexcept;
+
+    void wrap_2pi_near_batch (const float *first, const float *last, float *d_first, int max_periods = 1) noexcept;
+
+    /// \brief applies wrap_minus_pi_pi_near to each angle in [first, last), writing the results to d_first
+    /// \param max_periods how far outside [-pi,pi) the angles may be, in periods, see basic_wrap_minus_pi_pi_near
+    ///
+    /// Vectorized where the processor allows it. d_first may be equal to first.
+    void wrap_minus_pi_pi_near_batch (const double *first, const double *last, double *d_first,
+                                      int max_periods = 1) noexcept;
+
+    void wrap_minus_pi_pi_near_batch (const float *first, const float *last, float *d_first,
+                                      int max_periods = 1) noexcept;
+
+    /// \brief in place wrap_2pi of each angle in [first, last)
+    inline void wrap_2pi_inplace (double *first, double *last) noexcept
+    { wrap_2pi_batch(first, last, first); }
+
+    /// \brief in place wrap_minus_pi_pi of each angle in [first, last)
+    inline void wrap_minus_pi_pi_inplace (double *first, double *last) noexcept
+    { wrap_minus_pi_pi_batch(first, last, first); }
+
+    inline void wrap_2pi_inplace (float *first, float *last) noexcept
+    { wrap_2pi_batch(first, last, first); }
+
+    inline void wrap_minus_pi_pi_inplace (float *first, float *last) noexcept
+    { wrap_minus_pi_pi_batch(first, last, first); }
+
+    /// \brief in place wrap_2pi of a contiguous container (e.g. std::vector or std::array) of doubles or floats
+    template<typename ContiguousRange>
+    void wrap_2pi_inplace (ContiguousRange& angles) noexcept
+    { wrap_2pi_inplace(std::data(angles), std::data(angles) + std::size(angles)); }
+
+    /// \brief in place wrap_minus_pi_pi of a contiguous container (e.g. std::vector or std::array) of doubles or floats
+    template<typename ContiguousRange>
+    void wrap_minus_pi_pi_inplace (ContiguousRange& angles) noexcept
+    { wrap_minus_pi_pi_inplace(std::data(angles), std::data(angles) + std::size(angles)); }
+
+    namespace detail
+    {
+        /// \brief number of periods to add after a jump, to undo wrapping
+        ///
+        /// The jump is brought in [-pi,pi], jumps of exactly pi are left as they are.
+        /// The result is an integer, so that sums of it are exact, in any order.
+        template<typename T>
+        inline T unwrap_periods (T jump) noexcept
+        {
+          const T periods = jump * boost::math::constants::one_div_two_pi<T>();
+          return -std::copysign(std::ceil(std::abs(periods) - T(0.5)), periods);
+        }
+    }
+
+    /// \brief unwrap undoes the wrapping of a series of angles, e.g. a phase sampled in time
+    /// \param first, last the wrapped angles, read in a single pass
+    /// \param d_first receives last - first angles
+    /// \return the end of the output
+    ///
+    /// Whenever consecutive angles differ by more than pi, multiples of 2*pi are added to all the angles that follow,
+    /// so that the difference becomes at most pi. The first angle is copied unchanged.
+    /// The output is input + 2*pi*k, with k an exact integer, so the error is that of a single rounding.
+    template<typename InputIterator, typename OutputIterator>
+    OutputIterator unwrap (InputIterator first, InputIterator last, OutputIterator d_first)
+    {
+      using T = typename std::iterator_traits<InputIterator>::value_type;
+      static_assert(std::is_floating_point_v<T>, "unwrap: angles must be floating point values");
+
+      if (first == last)
+        return d_first;
+
+      T previous = *first;
+      T periods = 0;
+      *d_first++ = previous;
+
+      for (++first; first != last; ++first)
+        {
+          const T angle = *first;
+          periods += detail::unwrap_periods(angle - previous);
+          previous = angle;
+          *d_first++ = angle + boost::math::constants::two_pi<T>() * periods;
+        }
+      return d_first;
+    }
+
+    /// \brief unwrap of [first, last) to d_first, vectorized where the processor allows it
+    ///
+    /// d_first may be equal to first. Blocks without jumps greater than pi skip the prefix sum of the corrections.
+    void unwrap_batch (const double *first, const double *last, double *d_first) noexcept;
+
+    void unwrap_batch (const float *first, const float *last, float *d_first) noexcept;
+
+    /// \brief same as unwrap_batch, on n_threads threads
+    /// \param n_threads 0 means one thread per hardware thread
+    ///
+    /// Each thread first counts the periods added in its chunk, then unwraps it starting from the periods
+    /// of all the chunks before it. The output is identical to that of unwrap_batch.
+    /// Inputs shorter than 2^14 samples per thread use fewer threads. d_first may be equal to first.
+    void unwrap_parallel (const double *first, const double *last, double *d_first, unsigned n_threads);
+
+    void unwrap_parallel (const float *first, const float *last, float *d_first, unsigned n_threads);
+
+    /// \brief in place unwrap_batch of a contiguous container (e.g. std::vector or std::array) of doubles or floats
+    template<typename ContiguousRange>
+    void unwrap_inplace (ContiguousRange& angles) noexcept
+    { unwrap_batch(std::data(angles), std::data(angles) + std::size(angles), std::data(angles)); }
 
 }
 #endif //MYUTILITIES_WRAP_HPP
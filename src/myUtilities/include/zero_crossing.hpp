@@ -5,7 +5,18 @@
 #ifndef MYUTILITIES_ZERO_CROSSING_HPP
 #define MYUTILITIES_ZERO_CROSSING_HPP
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <boost/range.hpp>
+#include <boost/math/tools/toms748_solve.hpp>
 
 namespace PanosUtilities
 {
@@ -25,7 +36,7 @@ namespace PanosUtilities
     SinglePassIterator my_adjacent_find (SinglePassIterator first, SinglePassIterator last,
                                          BinaryPredicate p)
     {
-      using ValueType = typename SinglePassIterator::value_type;
+      using ValueType = typename std::iterator_traits<SinglePassIterator>::value_type;
       if (first == last)
         {
           return last;
@@ -47,22 +58,210 @@ namespace PanosUtilities
       return last;
     }
 
+    /// \brief result of a search for a zero crossing of transformed values
+    template<typename Iterator, typename Value>
+    struct TransformedZeroCross {
+      /// the last of the two elements that cross zero, or the end of the range if there is no crossing
+      Iterator position;
+      /// the transformed value of the element before position
+      Value previous_value;
+      /// the transformed value of position
+      Value value;
+    };
+
+    namespace detail
+    {
+        template<typename Iterator, typename Functor>
+        using transformed_value_t =
+        std::decay_t<std::invoke_result_t<Functor&, typename std::iterator_traits<Iterator>::reference>>;
+
+        /// \brief like my_adjacent_find, with p applied on the transformed elements
+        ///
+        /// Each element is transformed exactly once.
+        /// If there is no crossing, the values of the result are those of the last element, or value initialized.
+        template<typename SinglePassIterator, typename Functor, typename BinaryPredicate>
+        TransformedZeroCross<SinglePassIterator, transformed_value_t<SinglePassIterator, Functor>>
+        adjacent_find_transformed (SinglePassIterator first, SinglePassIterator last,
+                                   Functor& tr_function, BinaryPredicate p)
+        {
+          using Value = transformed_value_t<SinglePassIterator, Functor>;
+
+          if (first == last)
+            return {last, Value{}, Value{}};
+
+          Value previous_value = tr_function(*first);
+          ++first;
+
+          while (first != last)
+            {
+              Value cur_value = tr_function(*first);
+              if (p(previous_value, cur_value))
+                return {first, std::move(previous_value), std::move(cur_value)};
+
+              previous_value = std::move(cur_value);
+              ++first;
+            }
+          return {last, previous_value, previous_value};
+        }
+
+        /// \brief calls on_match(position) for the first max_matches adjacent pairs whose transformed values satisfy p
+        /// \return the position of the last match, if max_matches were found, otherwise last
+        ///
+        /// Each element visited is transformed exactly once. Elements after the last match are not visited.
+        template<typename SinglePassIterator, typename Functor, typename BinaryPredicate, typename Callback>
+        SinglePassIterator for_each_adjacent_transformed_n (SinglePassIterator first, SinglePassIterator last,
+                                                            Functor& tr_function, BinaryPredicate p,
+                                                            std::size_t max_matches, Callback on_match)
+        {
+          using Value = transformed_value_t<SinglePassIterator, Functor>;
+
+          if (max_matches == 0 || first == last)
+            return first;
+
+          Value previous_value = tr_function(*first);
+          ++first;
+
+          while (first != last)
+            {
+              Value cur_value = tr_function(*first);
+              if (p(previous_value, cur_value))
+                {
+                  on_match(first);
+                  if (--max_matches == 0)
+                    return first;
+                }
+
+              previous_value = std::move(cur_value);
+              ++first;
+            }
+          return last;
+        }
+
+        /// \brief calls on_match(position) for every adjacent pair whose transformed values satisfy p
+        ///
+        /// Each element is transformed exactly once.
+        template<typename SinglePassIterator, typename Functor, typename BinaryPredicate, typename Callback>
+        void for_each_adjacent_transformed (SinglePassIterator first, SinglePassIterator last,
+                                            Functor& tr_function, BinaryPredicate p, Callback on_match)
+        {
+          for_each_adjacent_transformed_n(first, last, tr_function, p,
+                                          std::numeric_limits<std::size_t>::max(), on_match);
+        }
+
+        /// \brief number of adjacent pairs whose transformed values satisfy p
+        template<typename SinglePassIterator, typename Functor, typename BinaryPredicate>
+        std::size_t count_adjacent_transformed (SinglePassIterator first, SinglePassIterator last,
+                                                Functor& tr_function, BinaryPredicate p)
+        {
+          std::size_t count = 0;
+          for_each_adjacent_transformed(first, last, tr_function, p, [&count] (SinglePassIterator)
+          { ++count; });
+          return count;
+        }
+
+        inline auto sign_change (int direction)
+        {
+          return [direction] (auto d1, auto d2)
+          { return different_sign(d1, d2, direction); };
+        }
+
+        inline auto sign_change (double max_distance, int direction)
+        {
+          return [max_distance, direction] (auto d1, auto d2)
+          { return different_sign(d1, d2, direction) && std::abs(d1 - d2) < max_distance; };
+        }
+    }
+
+    namespace detail
+    {
+        /// vectorized searches over contiguous memory, with the semantics of find_zero_cross
+        const double *find_zero_cross_contiguous (const double *first, const double *last, int direction) noexcept;
+
+        const float *find_zero_cross_contiguous (const float *first, const float *last, int direction) noexcept;
+
+        const double *find_zero_cross_contiguous (const double *first, const double *last,
+                                                  double max_distance, int direction) noexcept;
+
+        const float *find_zero_cross_contiguous (const float *first, const float *last,
+                                                 double max_distance, int direction) noexcept;
+
+        /// vectorized counts over contiguous memory, with the semantics of count_zero_cross
+        std::size_t count_zero_cross_contiguous (const double *first, const double *last, int direction) noexcept;
+
+        std::size_t count_zero_cross_contiguous (const float *first, const float *last, int direction) noexcept;
+
+        std::size_t count_zero_cross_contiguous (const double *first, const double *last,
+                                                 double max_distance, int direction) noexcept;
+
+        std::size_t count_zero_cross_contiguous (const float *first, const float *last,
+                                                 double max_distance, int direction) noexcept;
+
+        template<typename Iterator>
+        using iterator_value_t = std::remove_cv_t<typename std::iterator_traits<Iterator>::value_type>;
+
+        /// true for pointers and std::vector iterators to double or float,
+        /// and in C++20 for any contiguous iterator to them, e.g. those of std::span
+        template<typename Iterator, typename Value = iterator_value_t<Iterator>>
+        constexpr bool has_contiguous_kernel_v =
+            (std::is_same_v<Value, double> || std::is_same_v<Value, float>)
+            && (std::is_pointer_v<Iterator>
+                || std::is_same_v<Iterator, typename std::vector<Value>::iterator>
+                || std::is_same_v<Iterator, typename std::vector<Value>::const_iterator>
+#if defined(__cpp_lib_concepts)
+                || std::contiguous_iterator<Iterator>
+#endif
+            );
+
+        /// \brief calls kernel on the memory spanned by [v_begin, v_end) and maps the resulting pointer back to an Iterator
+        template<typename Iterator, typename Kernel>
+        Iterator call_contiguous_kernel (Iterator v_begin, Iterator v_end, Kernel kernel)
+        {
+          if (v_begin == v_end)
+            return v_end;
+
+          const auto first = &*v_begin;
+          const auto last = first + (v_end - v_begin);
+
+          return v_begin + (kernel(first, last) - first);
+        }
+
+        /// \brief calls kernel on the memory spanned by [v_begin, v_end) and returns its count
+        template<typename Iterator, typename Kernel>
+        std::size_t call_contiguous_count (Iterator v_begin, Iterator v_end, Kernel kernel)
+        {
+          if (v_begin == v_end)
+            return 0;
+
+          const auto first = &*v_begin;
+          return kernel(first, first + (v_end - v_begin));
+        }
+    }
+
     /// \brief finds first zero crossing
     /// \tparam Iterator type must satisfy the Single Pass iterator concept
     /// \param v_begin
     /// \param v_end
     /// \return iterator pointing to the last of the two elements that cross zero
     ///
-    /// Iterator::value_type must be copy constructible and copy assignable
+    /// Iterator::value_type must be copy constructible and copy assignable.
+    /// Pointers and std::vector iterators to double or float are searched with a vectorized kernel.
     template<typename Iterator>
     Iterator find_zero_cross (Iterator v_begin,
                               Iterator v_end,
                               int direction = 0)
     {
-      const auto my_fn = [direction] (auto x, auto y)
-      { return different_sign(x, y, direction); };
+      if constexpr (detail::has_contiguous_kernel_v<Iterator>)
+        {
+          return detail::call_contiguous_kernel(v_begin, v_end, [direction] (auto first, auto last)
+          { return detail::find_zero_cross_contiguous(first, last, direction); });
+        }
+      else
+        {
+          const auto my_fn = [direction] (auto x, auto y)
+          { return different_sign(x, y, direction); };
 
-      return my_adjacent_find(v_begin, v_end, my_fn);
+          return my_adjacent_find(v_begin, v_end, my_fn);
+        }
     }
 
 
@@ -73,7 +272,8 @@ namespace PanosUtilities
     /// \param tr_function a unary function with argument of type Iterator::value_type
     /// \return iterator pointing to the last of the two elements that cross zero
     ///
-    /// Iterator::value_type must be copy constructible and copy assignable
+    /// Iterator::value_type must be copy constructible and copy assignable.
+    /// tr_function is called exactly once per element visited.
 
     template<typename Iterator, typename Functor>
     Iterator find_zero_cross_transformed (Iterator v_begin,
@@ -81,13 +281,21 @@ namespace PanosUtilities
                                           Functor tr_function,
                                           int direction = 0)
     {
+      return detail::adjacent_find_transformed(v_begin, v_end, tr_function, detail::sign_change(direction)).position;
+    }
 
-      const auto filtered_fn = [fn = tr_function, dir = direction] (auto x, auto y)
-      {
-          return different_sign(fn(x), fn(y), dir);
-      };
-
-      return my_adjacent_find(v_begin, v_end, filtered_fn);
+    /// \brief same as find_zero_cross_transformed, also returning the transformed values of the crossing pair
+    /// \return see TransformedZeroCross
+    ///
+    /// The values returned by tr_function must be default constructible.
+    template<typename Iterator, typename Functor>
+    TransformedZeroCross<Iterator, detail::transformed_value_t<Iterator, Functor>>
+    find_zero_cross_transformed_values (Iterator v_begin,
+                                        Iterator v_end,
+                                        Functor tr_function,
+                                        int direction = 0)
+    {
+      return detail::adjacent_find_transformed(v_begin, v_end, tr_function, detail::sign_change(direction));
     }
 
     template<typename Iterator>
@@ -96,18 +304,25 @@ namespace PanosUtilities
                               double max_distance,
                               int direction = 0)
     {
+      if constexpr (detail::has_contiguous_kernel_v<Iterator>)
+        {
+          return detail::call_contiguous_kernel(v_begin, v_end, [max_distance, direction] (auto first, auto last)
+          { return detail::find_zero_cross_contiguous(first, last, max_distance, direction); });
+        }
+      else
+        {
+          const auto not_too_far = [threshold = max_distance] (auto d1, auto d2)
+          {
+              return std::abs(d1 - d2) < threshold;
+          };
 
-      const auto not_too_far = [threshold = max_distance] (auto d1, auto d2)
-      {
-          return std::abs(d1 - d2) < threshold;
-      };
-
-      const auto true_zero_cross = [check_valid = not_too_far, dir = direction] (auto d1, auto d2)
-      {
-          return different_sign(d1, d2, dir) && check_valid(d1, d2);
-      };
+          const auto true_zero_cross = [check_valid = not_too_far, dir = direction] (auto d1, auto d2)
+          {
+              return different_sign(d1, d2, dir) && check_valid(d1, d2);
+          };
 
-      return my_adjacent_find(v_begin, v_end, true_zero_cross);
+          return my_adjacent_find(v_begin, v_end, true_zero_cross);
+        }
     }
 
     template<typename Iterator, typename Functor>
@@ -117,24 +332,20 @@ namespace PanosUtilities
                                           double max_distance,
                                           int direction = 0)
     {
+      return detail::adjacent_find_transformed(v_begin, v_end, tr_function,
+                                               detail::sign_change(max_distance, direction)).position;
+    }
 
-      const auto not_too_far = [threshold = max_distance] (auto d1, auto d2)
-      {
-          return std::abs(d1 - d2) < threshold;
-      };
-
-      const auto true_zero_cross = [check_valid = not_too_far, dir = direction] (auto d1, auto d2)
-      {
-          return different_sign(d1, d2, dir) && check_valid(d1, d2);
-      };
-
-      const auto filtered_fn =
-          [transform = tr_function, fn = true_zero_cross] (auto x, auto y)
-          {
-              return fn(transform(x), transform(y));
-          };
-
-      return my_adjacent_find(v_begin, v_end, filtered_fn);
+    template<typename Iterator, typename Functor>
+    TransformedZeroCross<Iterator, detail::transformed_value_t<Iterator, Functor>>
+    find_zero_cross_transformed_values (Iterator v_begin,
+                                        Iterator v_end,
+                                        Functor tr_function,
+                                        double max_distance,
+                                        int direction = 0)
+    {
+      return detail::adjacent_find_transformed(v_begin, v_end, tr_function,
+                                               detail::sign_change(max_distance, direction));
     }
 
     template<typename OutputIterator, typename InputIterator>
@@ -148,7 +359,7 @@ namespace PanosUtilities
 
       while (v_first != v_end)
         {
-          out = *v_first;
+          *out++ = *v_first;
           v_first = find_zero_cross(v_first, v_end, direction);
         }
 
@@ -161,14 +372,9 @@ namespace PanosUtilities
                                  Functor tr_function,
                                  int direction = 0)
     {
-      auto v_first = find_zero_cross_transformed(v_begin, v_end, tr_function, direction);
-
-      while (v_first != v_end)
-        {
-          out = *v_first;
-          v_first = find_zero_cross_transformed(v_first, v_end, tr_function, direction);
-        }
-
+      detail::for_each_adjacent_transformed(v_begin, v_end, tr_function, detail::sign_change(direction),
+                                            [&out] (InputIterator v_first)
+                                            { *out++ = *v_first; });
     }
 
     template<typename OutputIterator, typename InputIterator>
@@ -182,7 +388,7 @@ namespace PanosUtilities
 
       while (v_first != v_end)
         {
-          out = *v_first;
+          *out++ = *v_first;
           v_first = find_zero_cross(v_first, v_end, max_distance, direction);
         }
 
@@ -196,58 +402,950 @@ namespace PanosUtilities
                                  double max_distance,
                                  int direction = 0)
     {
-      auto v_first = find_zero_cross_transformed(v_begin, v_end,
-                                                 tr_function,
-                                                 max_distance,
-                                                 direction);
-
-      while (v_first != v_end)
-        {
-          out = *v_first;
-          v_first = find_zero_cross_transformed(v_first, v_end,
-                                                tr_function,
-                                                max_distance,
-                                                direction);
-        }
-
+      detail::for_each_adjacent_transformed(v_begin, v_end, tr_function, detail::sign_change(max_distance, direction),
+                                            [&out] (InputIterator v_first)
+                                            { *out++ = *v_first; });
     }
 
+    /// \brief zero_cross on a whole range
+    /// \param range anything with std::begin and std::end of the same type, e.g. a container,
+    /// a boost range or, in C++20, a std::span or a common view
+    ///
+    /// The range is taken by forwarding reference, so it is never copied, not even when it is a temporary.
     template<typename Range, typename OutputIterator>
-    void zero_cross (Range range, OutputIterator out, int direction = 0)
+    void zero_cross (Range&& range, OutputIterator out, int direction = 0)
     {
-      zero_cross(std::cbegin(range), std::cend(range), out, direction);
+      zero_cross(std::begin(range), std::end(range), out, direction);
     }
 
+    /// \brief zero_cross_transformed on a whole range, see zero_cross
     template<typename Range, typename OutputIterator, typename Functor>
-    void zero_cross_transformed (Range range, OutputIterator out, Functor fn, int direction = 0)
+    void zero_cross_transformed (Range&& range, OutputIterator out, Functor fn, int direction = 0)
     {
-      zero_cross_transformed(std::cbegin(range), std::cend(range), out, fn, direction);
+      zero_cross_transformed(std::begin(range), std::end(range), out, fn, direction);
     }
 
     template<typename Range, typename OutputIterator>
-    void zero_cross (Range range,
+    void zero_cross (Range&& range,
                      OutputIterator out,
                      double max_distance,
                      int direction = 0)
     {
-      zero_cross(std::cbegin(range), std::cend(range), out, max_distance, direction);
+      zero_cross(std::begin(range), std::end(range), out, max_distance, direction);
     }
 
     template<typename Range, typename OutputIterator, typename Functor>
-    void zero_cross_transformed (Range range,
+    void zero_cross_transformed (Range&& range,
                                  OutputIterator out,
                                  Functor fn,
                                  double max_distance,
                                  int direction = 0)
     {
-      zero_cross_transformed(std::cbegin(range),
-                             std::cend(range),
+      zero_cross_transformed(std::begin(range),
+                             std::end(range),
                              out,
                              fn,
                              max_distance,
                              direction);
     }
 
+    /// \brief number of zero crossings in [v_begin, v_end), i.e. of the elements zero_cross would write
+    ///
+    /// Nothing is written and no crossing is located.
+    /// Pointers and std::vector iterators to double or float are counted with a vectorized kernel, without early exit.
+    template<typename InputIterator>
+    std::size_t count_zero_cross (InputIterator v_begin,
+                                  InputIterator v_end,
+                                  int direction = 0)
+    {
+      if constexpr (detail::has_contiguous_kernel_v<InputIterator>)
+        {
+          return detail::call_contiguous_count(v_begin, v_end, [direction] (auto first, auto last)
+          { return detail::count_zero_cross_contiguous(first, last, direction); });
+        }
+      else
+        {
+          auto identity = [] (const auto& x)
+          { return x; };
+          return detail::count_adjacent_transformed(v_begin, v_end, identity, detail::sign_change(direction));
+        }
+    }
+
+    template<typename InputIterator>
+    std::size_t count_zero_cross (InputIterator v_begin,
+                                  InputIterator v_end,
+                                  double max_distance,
+                                  int direction = 0)
+    {
+      if constexpr (detail::has_contiguous_kernel_v<InputIterator>)
+        {
+          return detail::call_contiguous_count(v_begin, v_end, [max_distance, direction] (auto first, auto last)
+          { return detail::count_zero_cross_contiguous(first, last, max_distance, direction); });
+        }
+      else
+        {
+          auto identity = [] (const auto& x)
+          { return x; };
+          return detail::count_adjacent_transformed(v_begin, v_end, identity,
+                                                    detail::sign_change(max_distance, direction));
+        }
+    }
+
+    /// \brief number of elements zero_cross_transformed would write
+    ///
+    /// tr_function is called exactly once per element.
+    template<typename InputIterator, typename Functor>
+    std::size_t count_zero_cross_transformed (InputIterator v_begin,
+                                              InputIterator v_end,
+                                              Functor tr_function,
+                                              int direction = 0)
+    {
+      return detail::count_adjacent_transformed(v_begin, v_end, tr_function, detail::sign_change(direction));
+    }
+
+    template<typename InputIterator, typename Functor>
+    std::size_t count_zero_cross_transformed (InputIterator v_begin,
+                                              InputIterator v_end,
+                                              Functor tr_function,
+                                              double max_distance,
+                                              int direction = 0)
+    {
+      return detail::count_adjacent_transformed(v_begin, v_end, tr_function,
+                                                detail::sign_change(max_distance, direction));
+    }
+
+    template<typename Range>
+    std::size_t count_zero_cross (Range&& range, int direction = 0)
+    {
+      return count_zero_cross(std::begin(range), std::end(range), direction);
+    }
+
+    template<typename Range>
+    std::size_t count_zero_cross (Range&& range, double max_distance, int direction = 0)
+    {
+      return count_zero_cross(std::begin(range), std::end(range), max_distance, direction);
+    }
+
+    template<typename Range, typename Functor>
+    std::size_t count_zero_cross_transformed (Range&& range, Functor fn, int direction = 0)
+    {
+      return count_zero_cross_transformed(std::begin(range), std::end(range), fn, direction);
+    }
+
+    template<typename Range, typename Functor>
+    std::size_t count_zero_cross_transformed (Range&& range, Functor fn, double max_distance, int direction = 0)
+    {
+      return count_zero_cross_transformed(std::begin(range), std::end(range), fn, max_distance, direction);
+    }
+
+    /// \brief same as zero_cross, writing at most the first n crossings
+    /// \return the position of the n-th crossing if there are at least n, otherwise v_end
+    ///
+    /// The search stops at the n-th crossing, so that the elements after it are not visited.
+    /// Passing the returned position as v_begin of another call continues with the crossings that follow.
+    template<typename OutputIterator, typename InputIterator>
+    InputIterator zero_cross_n (InputIterator v_begin,
+                                InputIterator v_end,
+                                OutputIterator out,
+                                std::size_t n,
+                                int direction = 0)
+    {
+      if (n == 0)
+        return v_begin;
+
+      auto v_first = find_zero_cross(v_begin, v_end, direction);
+
+      while (v_first != v_end)
+        {
+          *out++ = *v_first;
+          if (--n == 0)
+            break;
+          v_first = find_zero_cross(v_first, v_end, direction);
+        }
+
+      return v_first;
+    }
+
+    template<typename OutputIterator, typename InputIterator>
+    InputIterator zero_cross_n (InputIterator v_begin,
+                                InputIterator v_end,
+                                OutputIterator out,
+                                std::size_t n,
+                                double max_distance,
+                                int direction = 0)
+    {
+      if (n == 0)
+        return v_begin;
+
+      auto v_first = find_zero_cross(v_begin, v_end, max_distance, direction);
+
+      while (v_first != v_end)
+        {
+          *out++ = *v_first;
+          if (--n == 0)
+            break;
+          v_first = find_zero_cross(v_first, v_end, max_distance, direction);
+        }
+
+      return v_first;
+    }
+
+    /// \brief same as zero_cross_transformed, writing at most the first n crossings, see zero_cross_n
+    ///
+    /// tr_function is called exactly once per element visited.
+    template<typename OutputIterator, typename InputIterator, typename Functor>
+    InputIterator zero_cross_transformed_n (InputIterator v_begin,
+                                            InputIterator v_end,
+                                            OutputIterator out,
+                                            std::size_t n,
+                                            Functor tr_function,
+                                            int direction = 0)
+    {
+      return detail::for_each_adjacent_transformed_n(v_begin, v_end, tr_function, detail::sign_change(direction), n,
+                                                     [&out] (InputIterator v_first)
+                                                     { *out++ = *v_first; });
+    }
+
+    template<typename OutputIterator, typename InputIterator, typename Functor>
+    InputIterator zero_cross_transformed_n (InputIterator v_begin,
+                                            InputIterator v_end,
+                                            OutputIterator out,
+                                            std::size_t n,
+                                            Functor tr_function,
+                                            double max_distance,
+                                            int direction = 0)
+    {
+      return detail::for_each_adjacent_transformed_n(v_begin, v_end, tr_function,
+                                                     detail::sign_change(max_distance, direction), n,
+                                                     [&out] (InputIterator v_first)
+                                                     { *out++ = *v_first; });
+    }
+
+    /// \brief zero_cross_n on a whole range, see zero_cross
+    /// \return the position in range, which dangles if range is a temporary
+    template<typename Range, typename OutputIterator>
+    auto zero_cross_n (Range&& range, OutputIterator out, std::size_t n, int direction = 0)
+    {
+      return zero_cross_n(std::begin(range), std::end(range), out, n, direction);
+    }
+
+    template<typename Range, typename OutputIterator>
+    auto zero_cross_n (Range&& range, OutputIterator out, std::size_t n, double max_distance, int direction = 0)
+    {
+      return zero_cross_n(std::begin(range), std::end(range), out, n, max_distance, direction);
+    }
+
+    template<typename Range, typename OutputIterator, typename Functor>
+    auto zero_cross_transformed_n (Range&& range, OutputIterator out, std::size_t n, Functor fn, int direction = 0)
+    {
+      return zero_cross_transformed_n(std::begin(range), std::end(range), out, n, fn, direction);
+    }
+
+    template<typename Range, typename OutputIterator, typename Functor>
+    auto zero_cross_transformed_n (Range&& range,
+                                   OutputIterator out,
+                                   std::size_t n,
+                                   Functor fn,
+                                   double max_distance,
+                                   int direction = 0)
+    {
+      return zero_cross_transformed_n(std::begin(range), std::end(range), out, n, fn, max_distance, direction);
+    }
+
+    /// \brief detects zero crossings in a signal arriving one sample (or one block of samples) at a time
+    /// \tparam T type of the samples
+    ///
+    /// The crossings reported are the ones zero_cross would find on the concatenation of all the samples pushed.
+    /// Samples are identified by their index in that concatenation. No allocation takes place.
+    template<typename T = double>
+    class ZeroCrossDetector {
+      int direction_;
+      bool limit_distance_;
+      double max_distance_;
+      T previous_{};
+      std::size_t n_samples_{0};
+
+      bool crosses (T d1, T d2) const noexcept
+      {
+        return different_sign(d1, d2, direction_) && (!limit_distance_ || std::abs(d1 - d2) < max_distance_);
+      }
+
+     public:
+      explicit ZeroCrossDetector (int direction = 0) noexcept
+          : direction_{direction}, limit_distance_{false}, max_distance_{0}
+      {}
+
+      explicit ZeroCrossDetector (double max_distance, int direction = 0) noexcept
+          : direction_{direction}, limit_distance_{true}, max_distance_{max_distance}
+      {}
+
+      /// \return true if value and the previous sample cross zero
+      bool push (T value) noexcept
+      {
+        const bool crossed = n_samples_ != 0 && crosses(previous_, value);
+        previous_ = value;
+        ++n_samples_;
+        return crossed;
+      }
+
+      /// \brief pushes all the samples in [first, last)
+      /// \tparam Iterator type must satisfy the Bidirectional iterator concept
+      /// \return out, after writing the index of every sample that crossed zero
+      ///
+      /// Contiguous blocks of double or float are searched with the vectorized find_zero_cross
+      template<typename Iterator, typename OutputIterator>
+      OutputIterator push (Iterator first, Iterator last, OutputIterator out)
+      {
+        if (first == last)
+          return out;
+
+        std::size_t index = n_samples_;
+        if (push(*first))
+          *out++ = index;
+
+        const auto find = [this] (Iterator v_first, Iterator v_last)
+        {
+            return limit_distance_ ? find_zero_cross(v_first, v_last, max_distance_, direction_)
+                                   : find_zero_cross(v_first, v_last, direction_);
+        };
+
+        auto v_previous = first;
+        auto v_first = find(first, last);
+        while (v_first != last)
+          {
+            index += static_cast<std::size_t>(std::distance(v_previous, v_first));
+            *out++ = index;
+            v_previous = v_first;
+            v_first = find(v_first, last);
+          }
+
+        const auto block_size = static_cast<std::size_t>(std::distance(first, last));
+        previous_ = *std::prev(last);
+        n_samples_ += block_size - 1;
+
+        return out;
+      }
+
+      template<typename Range, typename OutputIterator>
+      OutputIterator push (const Range& block, OutputIterator out)
+      {
+        return push(std::cbegin(block), std::cend(block), out);
+      }
+
+      /// \return the number of samples pushed so far
+      std::size_t samples () const noexcept
+      {
+        return n_samples_;
+      }
+
+      /// \brief forgets all the samples pushed so far
+      void reset () noexcept
+      {
+        n_samples_ = 0;
+      }
+    };
+
+    /// \brief a zero crossing of one channel of multi-channel data
+    struct ChannelCrossing {
+      std::size_t channel;
+      /// index of the last of the two samples that cross zero, as reported by ZeroCrossDetector
+      std::size_t index;
+
+      friend bool operator== (const ChannelCrossing& a, const ChannelCrossing& b) noexcept
+      { return a.channel == b.channel && a.index == b.index; }
+
+      friend bool operator!= (const ChannelCrossing& a, const ChannelCrossing& b) noexcept
+      { return !(a == b); }
+    };
+
+    namespace detail
+    {
+        /// \brief sets bit j % 64 of mask[j / 64] if first[j - lag] and first[j] cross zero, and clears it otherwise
+        ///
+        /// first[-lag] to first[-1] must be readable. Vectorized, like find_zero_cross_contiguous.
+        void zero_cross_mask (const double *first, const double *last, std::size_t lag, int direction,
+                              std::uint64_t *mask) noexcept;
+
+        void zero_cross_mask (const float *first, const float *last, std::size_t lag, int direction,
+                              std::uint64_t *mask) noexcept;
+
+        /// samples of each channel tested per block, so that the masks of all the channels stay in L1
+        constexpr std::size_t channel_block_words = 16;
+
+        inline unsigned lowest_set_bit (std::uint64_t word) noexcept
+        {
+#if defined(__GNUC__)
+          return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+          unsigned bit = 0;
+          while (!(word & 1))
+            {
+              word >>= 1;
+              ++bit;
+            }
+          return bit;
+#endif
+        }
+
+        /// \brief calls on_block(block_begin, masks) for consecutive blocks of the samples [1, length) of every channel
+        ///
+        /// masks[c * channel_block_words + w] holds the crossings of channel c at samples block_begin + 64 * w + bit.
+        template<typename T, typename Callback>
+        void for_each_channel_block (const T *const *channels, std::size_t n_channels, std::size_t length,
+                                     int direction, Callback on_block)
+        {
+          constexpr std::size_t block_size = 64 * channel_block_words;
+          std::vector<std::uint64_t> masks(n_channels * channel_block_words);
+
+          for (std::size_t block_begin = 1; block_begin < length; block_begin += block_size)
+            {
+              const auto block_end = std::min(length, block_begin + block_size);
+              for (std::size_t c = 0; c < n_channels; ++c)
+                zero_cross_mask(channels[c] + block_begin, channels[c] + block_end, 1, direction,
+                                masks.data() + c * channel_block_words);
+
+              on_block(block_begin, (block_end - block_begin + 63) / 64, masks);
+            }
+        }
+    }
+
+    /// \brief zero crossings of n_channels channels of length samples each, in structure of arrays layout
+    /// \tparam T double or float
+    /// \param channels n_channels pointers, to the samples of each channel
+    /// \param out receives a ChannelCrossing for every crossing, ordered by index and then by channel
+    /// \return out, after the last crossing
+    ///
+    /// All the channels are scanned together, one block of samples at a time, with the vectorized test
+    /// of find_zero_cross, and the crossings of the block are then merged in order.
+    template<typename T, typename OutputIterator>
+    OutputIterator zero_cross_channels (const T *const *channels, std::size_t n_channels, std::size_t length,
+                                        OutputIterator out, int direction = 0)
+    {
+      using detail::channel_block_words;
+
+      detail::for_each_channel_block(channels, n_channels, length, direction,
+                                     [&] (std::size_t block_begin, std::size_t n_words,
+                                          const std::vector<std::uint64_t>& masks)
+                                     {
+                                         for (std::size_t w = 0; w < n_words; ++w)
+                                           {
+                                             std::uint64_t any = 0;
+                                             for (std::size_t c = 0; c < n_channels; ++c)
+                                               any |= masks[c * channel_block_words + w];
+
+                                             for (; any != 0; any &= any - 1)
+                                               {
+                                                 const auto bit = detail::lowest_set_bit(any);
+                                                 for (std::size_t c = 0; c < n_channels; ++c)
+                                                   if ((masks[c * channel_block_words + w] >> bit) & 1u)
+                                                     *out++ = ChannelCrossing{c, block_begin + 64 * w + bit};
+                                               }
+                                           }
+                                     });
+      return out;
+    }
+
+    /// \brief same as zero_cross_channels, with the indices of the crossings of channel c written to outs[c]
+    template<typename T, typename OutputIterator>
+    void zero_cross_per_channel (const T *const *channels, std::size_t n_channels, std::size_t length,
+                                 OutputIterator *outs, int direction = 0)
+    {
+      using detail::channel_block_words;
+
+      detail::for_each_channel_block(channels, n_channels, length, direction,
+                                     [&] (std::size_t block_begin, std::size_t n_words,
+                                          const std::vector<std::uint64_t>& masks)
+                                     {
+                                         for (std::size_t c = 0; c < n_channels; ++c)
+                                           for (std::size_t w = 0; w < n_words; ++w)
+                                             for (auto word = masks[c * channel_block_words + w];
+                                                  word != 0; word &= word - 1)
+                                               *outs[c]++ = block_begin + 64 * w + detail::lowest_set_bit(word);
+                                     });
+    }
+
+    /// \brief zero crossings of n_channels channels interleaved sample by sample, in array of structures layout
+    /// \tparam T double or float
+    /// \param data length * n_channels samples, data[i * n_channels + c] being sample i of channel c
+    /// \param out receives a ChannelCrossing for every crossing, ordered by index and then by channel
+    /// \return out, after the last crossing
+    ///
+    /// Each sample is tested against the one n_channels positions before it, so that the whole array is
+    /// scanned in a single vectorized pass, without projecting out the channels.
+    template<typename T, typename OutputIterator>
+    OutputIterator zero_cross_interleaved (const T *data, std::size_t n_channels, std::size_t length,
+                                           OutputIterator out, int direction = 0)
+    {
+      constexpr std::size_t block_size = 64 * detail::channel_block_words;
+
+      if (n_channels == 0 || length < 2)
+        return out;
+
+      const auto size = n_channels * length;
+      std::uint64_t mask[detail::channel_block_words];
+
+      for (std::size_t block_begin = n_channels; block_begin < size; block_begin += block_size)
+        {
+          const auto block_end = std::min(size, block_begin + block_size);
+          detail::zero_cross_mask(data + block_begin, data + block_end, n_channels, direction, mask);
+
+          for (std::size_t w = 0; w < (block_end - block_begin + 63) / 64; ++w)
+            for (auto word = mask[w]; word != 0; word &= word - 1)
+              {
+                const auto j = block_begin + 64 * w + detail::lowest_set_bit(word);
+                *out++ = ChannelCrossing{j % n_channels, j / n_channels};
+              }
+        }
+      return out;
+    }
+
+    enum class Interpolation { linear, cubic };
+
+    namespace detail
+    {
+        /// \brief root in [0, 1] of the cubic Hermite segment with values y0, y1 and slopes m0, m1 at 0 and 1
+        ///
+        /// y0 and y1 must have different signs, or y1 must be zero
+        inline double hermite_root (double y0, double y1, double m0, double m1) noexcept
+        {
+          const auto p = [=] (double t)
+          {
+              const double t2 = t * t;
+              const double t3 = t2 * t;
+              return (2 * t3 - 3 * t2 + 1) * y0 + (t3 - 2 * t2 + t) * m0 + (-2 * t3 + 3 * t2) * y1 + (t3 - t2) * m1;
+          };
+          const auto dp = [=] (double t)
+          {
+              const double t2 = t * t;
+              return (6 * t2 - 6 * t) * (y0 - y1) + (3 * t2 - 4 * t + 1) * m0 + (3 * t2 - 2 * t) * m1;
+          };
+
+          if (y1 == 0)
+            return 1;
+
+          //Newton iterations, falling back to bisection when leaving the bracket
+          double low = 0;
+          double high = 1;
+          double t = y0 / (y0 - y1);
+          for (int iteration = 0; iteration < 50; ++iteration)
+            {
+              const double value = p(t);
+              if (value == 0)
+                break;
+
+              if ((value < 0) == (y0 < 0))
+                low = t;
+              else
+                high = t;
+
+              const double slope = dp(t);
+              double next = (slope != 0) ? t - value / slope : low;
+              if (!(next > low && next < high))
+                next = 0.5 * (low + high);
+
+              if (std::abs(next - t) <= 1e-15)
+                {
+                  t = next;
+                  break;
+                }
+              t = next;
+            }
+          return t;
+        }
+
+        /// \brief calls emit(i, t) for every pair (i-1, i) satisfying p, where t in (0, 1] locates the zero between them
+        ///
+        /// Single pass. With cubic interpolation, the zero is emitted after reading element i+1,
+        /// which is used, along with element i-2, to estimate the slopes at both ends of the pair.
+        template<typename SinglePassIterator, typename BinaryPredicate, typename Emit>
+        void for_each_interpolated_crossing (SinglePassIterator first, SinglePassIterator last,
+                                             BinaryPredicate p, Interpolation interpolation, Emit emit)
+        {
+          if (first == last)
+            return;
+
+          std::size_t index = 0;
+          double before_previous = 0;
+          bool has_before_previous = false;
+          double previous = static_cast<double>(*first);
+          ++first;
+
+          bool pending = false;
+          std::size_t pending_index = 0;
+          double pending_slope = 0;
+
+          const auto resolve_pending = [&] (double y0, double y1, double slope_at_y1)
+          {
+              emit(pending_index, hermite_root(y0, y1, pending_slope, slope_at_y1));
+              pending = false;
+          };
+
+          //values of the pending pair are (before_previous, previous) when resolving
+          for (; first != last; ++first)
+            {
+              const double current = static_cast<double>(*first);
+              ++index;
+
+              if (pending)
+                resolve_pending(before_previous, previous, 0.5 * (current - before_previous));
+
+              if (p(previous, current))
+                {
+                  if (interpolation == Interpolation::linear)
+                    emit(index, previous / (previous - current));
+                  else
+                    {
+                      pending = true;
+                      pending_index = index;
+                      pending_slope = has_before_previous ? 0.5 * (current - before_previous) : current - previous;
+                    }
+                }
+
+              before_previous = previous;
+              has_before_previous = true;
+              previous = current;
+            }
+
+          if (pending)
+            resolve_pending(before_previous, previous, previous - before_previous);
+        }
+
+        /// \brief maps (i, t) to x[i-1] + t * (x[i] - x[i-1]), advancing x_it along the grid as needed
+        template<typename GridIterator>
+        class GridMapper {
+          GridIterator x_it_;
+          std::size_t index_{0};
+          double x_previous_{0};
+         public:
+          explicit GridMapper (GridIterator x_begin)
+              : x_it_{x_begin}
+          {}
+
+          double operator() (std::size_t i, double t)
+          {
+            while (index_ < i)
+              {
+                x_previous_ = static_cast<double>(*x_it_);
+                ++x_it_;
+                ++index_;
+              }
+            const double x_current = static_cast<double>(*x_it_);
+            return x_previous_ + t * (x_current - x_previous_);
+          }
+        };
+    }
+
+    /// \brief writes the fractional index of every zero crossing of [v_begin, v_end) to out
+    /// \param interpolation linear uses the two elements that cross zero, cubic also uses the element
+    /// before and after them to build a cubic Hermite (Catmull-Rom) segment
+    ///
+    /// A crossing between elements i-1 and i, as found by zero_cross, is written as the double i - 1 + t,
+    /// with t in (0, 1] the interpolated position of the zero. The input is read in a single pass.
+    template<typename OutputIterator, typename InputIterator>
+    void zero_cross_interpolated (InputIterator v_begin,
+                                  InputIterator v_end,
+                                  OutputIterator out,
+                                  int direction = 0,
+                                  Interpolation interpolation = Interpolation::linear)
+    {
+      detail::for_each_interpolated_crossing(v_begin, v_end, detail::sign_change(direction), interpolation,
+                                             [&out] (std::size_t i, double t)
+                                             { *out++ = static_cast<double>(i - 1) + t; });
+    }
+
+    template<typename OutputIterator, typename InputIterator>
+    void zero_cross_interpolated (InputIterator v_begin,
+                                  InputIterator v_end,
+                                  OutputIterator out,
+                                  double max_distance,
+                                  int direction = 0,
+                                  Interpolation interpolation = Interpolation::linear)
+    {
+      detail::for_each_interpolated_crossing(v_begin, v_end, detail::sign_change(max_distance, direction),
+                                             interpolation,
+                                             [&out] (std::size_t i, double t)
+                                             { *out++ = static_cast<double>(i - 1) + t; });
+    }
+
+    /// \brief writes the interpolated abscissa of every zero crossing of [v_begin, v_end) to out
+    /// \param x_begin the abscissae of the samples, e.g. the output of linspace. Read in a single pass,
+    /// along with the values
+    ///
+    /// The fractional position found like in zero_cross_interpolated is mapped linearly between
+    /// the abscissae of the two elements that cross zero.
+    template<typename OutputIterator, typename InputIterator, typename GridIterator>
+    void zero_cross_interpolated_abscissa (InputIterator v_begin,
+                                           InputIterator v_end,
+                                           GridIterator x_begin,
+                                           OutputIterator out,
+                                           int direction = 0,
+                                           Interpolation interpolation = Interpolation::linear)
+    {
+      detail::GridMapper<GridIterator> to_abscissa(x_begin);
+      detail::for_each_interpolated_crossing(v_begin, v_end, detail::sign_change(direction), interpolation,
+                                             [&out, &to_abscissa] (std::size_t i, double t)
+                                             { *out++ = to_abscissa(i, t); });
+    }
+
+    template<typename OutputIterator, typename InputIterator, typename GridIterator>
+    void zero_cross_interpolated_abscissa (InputIterator v_begin,
+                                           InputIterator v_end,
+                                           GridIterator x_begin,
+                                           OutputIterator out,
+                                           double max_distance,
+                                           int direction = 0,
+                                           Interpolation interpolation = Interpolation::linear)
+    {
+      detail::GridMapper<GridIterator> to_abscissa(x_begin);
+      detail::for_each_interpolated_crossing(v_begin, v_end, detail::sign_change(max_distance, direction),
+                                             interpolation,
+                                             [&out, &to_abscissa] (std::size_t i, double t)
+                                             { *out++ = to_abscissa(i, t); });
+    }
+
+    namespace detail
+    {
+        /// calls to f allowed for refining each root
+        constexpr std::uintmax_t max_root_iterations = 200;
+
+        /// \brief termination condition of toms748_solve
+        ///
+        /// The bracket must be narrower than x_tolerance, or, if x_tolerance is 0, as narrow as the precision of T allows.
+        template<typename T>
+        class RootTolerance {
+          T x_tolerance_;
+          boost::math::tools::eps_tolerance<T> full_precision_{};
+         public:
+          explicit RootTolerance (T x_tolerance) noexcept
+              : x_tolerance_{x_tolerance}
+          {}
+
+          bool operator() (T a, T b)
+          {
+            return x_tolerance_ > 0 ? std::abs(b - a) <= x_tolerance_ : full_precision_(a, b);
+          }
+        };
+
+        /// \brief calls on_root(root) for every sign change of f sampled on [x_begin, x_end), refined by TOMS 748
+        ///
+        /// f is called once per grid point, then at most max_root_iterations times per sign change.
+        template<typename ForwardIterator, typename Function, typename Callback>
+        void for_each_refined_root (ForwardIterator x_begin, ForwardIterator x_end, Function& f,
+                                    double x_tolerance, int direction, Callback on_root)
+        {
+          using T = iterator_value_t<ForwardIterator>;
+          static_assert(std::is_floating_point_v<T>, "the grid of the roots must be of floating point type");
+
+          if (x_begin == x_end)
+            return;
+
+          const auto g = [&f] (T x)
+          { return static_cast<T>(f(x)); };
+          const RootTolerance<T> tolerance(static_cast<T>(x_tolerance));
+
+          T x_previous = *x_begin;
+          T f_previous = g(x_previous);
+
+          for (auto x_it = std::next(x_begin); x_it != x_end; ++x_it)
+            {
+              const T x = *x_it;
+              const T f_x = g(x);
+
+              if (different_sign(f_previous, f_x, direction))
+                {
+                  if (f_x == 0)
+                    on_root(x);
+                  else
+                    {
+                      std::uintmax_t iterations = max_root_iterations;
+                      const auto bracket = boost::math::tools::toms748_solve(g, x_previous, x, f_previous, f_x,
+                                                                             tolerance, iterations);
+                      on_root(bracket.first + (bracket.second - bracket.first) / 2);
+                    }
+                }
+
+              x_previous = x;
+              f_previous = f_x;
+            }
+        }
+    }
+
+    /// \brief writes the roots of f between the points of a grid to out
+    /// \tparam ForwardIterator type must satisfy the Forward iterator concept, with a floating point value type
+    /// \param x_begin the grid, in increasing order, e.g. the output of uniform_samples
+    /// \param f callable returning a value convertible to the value type of the grid
+    /// \param x_tolerance each root is refined until it is bracketed in an interval of this width,
+    /// 0 means as narrow as the floating point type allows
+    /// \param direction as in zero_cross, of the values of f along the grid
+    ///
+    /// f is sampled on the grid and every pair of adjacent points where it crosses zero, as zero_cross_transformed
+    /// would find, is refined with the TOMS 748 algorithm of boost::math::tools::toms748_solve.
+    /// Only roots with a sign change between grid points are found, so the grid must be fine enough to separate them,
+    /// but not finer: the accuracy comes from the refinement.
+    /// If f is zero at a grid point, that point is the root.
+    template<typename OutputIterator, typename ForwardIterator, typename Function>
+    void zero_cross_roots (ForwardIterator x_begin,
+                           ForwardIterator x_end,
+                           OutputIterator out,
+                           Function f,
+                           double x_tolerance = 0,
+                           int direction = 0)
+    {
+      detail::for_each_refined_root(x_begin, x_end, f, x_tolerance, direction,
+                                    [&out] (auto root)
+                                    { *out++ = root; });
+    }
+
+    /// \brief zero_cross_roots on a whole grid, taken by reference as in zero_cross
+    template<typename Range, typename OutputIterator, typename Function>
+    void zero_cross_roots (Range&& grid,
+                           OutputIterator out,
+                           Function f,
+                           double x_tolerance = 0,
+                           int direction = 0)
+    {
+      zero_cross_roots(std::begin(grid), std::end(grid), out, f, x_tolerance, direction);
+    }
+
+    namespace detail
+    {
+        /// chunks smaller than this are not worth a thread of their own
+        constexpr std::ptrdiff_t min_parallel_chunk_size = 1 << 14;
+
+        /// \brief runs zero_cross_chunk concurrently on n_threads chunks of [v_begin, v_end), writing the crossings to out
+        /// \param zero_cross_chunk a callable such that zero_cross_chunk(first, last, out) writes the
+        /// zero crossings in [first, last) to out, like zero_cross does
+        ///
+        /// Each chunk starts one element before its share of the input, so that the pair
+        /// straddling the boundary is tested. The crossings are written in the order of the input.
+        template<typename OutputIterator, typename RandomAccessIterator, typename ZeroCross>
+        void zero_cross_parallel_impl (RandomAccessIterator v_begin,
+                                       RandomAccessIterator v_end,
+                                       OutputIterator out,
+                                       unsigned n_threads,
+                                       ZeroCross zero_cross_chunk,
+                                       std::ptrdiff_t min_chunk_size = min_parallel_chunk_size)
+        {
+          using Value = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+          if (n_threads == 0)
+            n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+          const auto size = v_end - v_begin;
+          const auto n_chunks = std::max(std::min<std::ptrdiff_t>(n_threads, size / min_chunk_size),
+                                         std::ptrdiff_t{1});
+
+          const auto find_all = [zero_cross_chunk] (RandomAccessIterator first, RandomAccessIterator last)
+          {
+              std::vector<Value> crossings;
+              zero_cross_chunk(first, last, std::back_inserter(crossings));
+              return crossings;
+          };
+
+          std::vector<std::future<std::vector<Value>>> chunks;
+          for (std::ptrdiff_t k = 0; k < n_chunks; ++k)
+            {
+              const auto chunk_begin = v_begin + std::max(k * size / n_chunks - 1, std::ptrdiff_t{0});
+              const auto chunk_end = v_begin + (k + 1) * size / n_chunks;
+              chunks.push_back(std::async(n_chunks == 1 ? std::launch::deferred : std::launch::async,
+                                          find_all, chunk_begin, chunk_end));
+            }
+
+          for (auto& chunk : chunks)
+            for (auto& crossing : chunk.get())
+              *out++ = std::move(crossing);
+        }
+    }
+
+    /// \brief same as zero_cross, searching on n_threads threads
+    /// \param n_threads 0 means one thread per hardware thread
+    ///
+    /// Inputs shorter than detail::min_parallel_chunk_size per thread use fewer threads.
+    template<typename OutputIterator, typename RandomAccessIterator>
+    void zero_cross_parallel (RandomAccessIterator v_begin,
+                              RandomAccessIterator v_end,
+                              OutputIterator out,
+                              unsigned n_threads,
+                              int direction = 0)
+    {
+      detail::zero_cross_parallel_impl(v_begin, v_end, out, n_threads,
+                                       [direction] (auto first, auto last, auto chunk_out)
+                                       { zero_cross(first, last, chunk_out, direction); });
+    }
+
+    template<typename OutputIterator, typename RandomAccessIterator>
+    void zero_cross_parallel (RandomAccessIterator v_begin,
+                              RandomAccessIterator v_end,
+                              OutputIterator out,
+                              unsigned n_threads,
+                              double max_distance,
+                              int direction = 0)
+    {
+      detail::zero_cross_parallel_impl(v_begin, v_end, out, n_threads,
+                                       [max_distance, direction] (auto first, auto last, auto chunk_out)
+                                       { zero_cross(first, last, chunk_out, max_distance, direction); });
+    }
+
+    /// \brief same as zero_cross_transformed, searching on n_threads threads
+    ///
+    /// tr_function is called concurrently from several threads
+    template<typename OutputIterator, typename RandomAccessIterator, typename Functor>
+    void zero_cross_transformed_parallel (RandomAccessIterator v_begin,
+                                          RandomAccessIterator v_end,
+                                          OutputIterator out,
+                                          unsigned n_threads,
+                                          Functor tr_function,
+                                          int direction = 0)
+    {
+      detail::zero_cross_parallel_impl(v_begin, v_end, out, n_threads,
+                                       [tr_function, direction] (auto first, auto last, auto chunk_out)
+                                       { zero_cross_transformed(first, last, chunk_out, tr_function, direction); });
+    }
+
+    template<typename OutputIterator, typename RandomAccessIterator, typename Functor>
+    void zero_cross_transformed_parallel (RandomAccessIterator v_begin,
+                                          RandomAccessIterator v_end,
+                                          OutputIterator out,
+                                          unsigned n_threads,
+                                          Functor tr_function,
+                                          double max_distance,
+                                          int direction = 0)
+    {
+      detail::zero_cross_parallel_impl(v_begin, v_end, out, n_threads,
+                                       [tr_function, max_distance, direction] (auto first, auto last, auto chunk_out)
+                                       {
+                                           zero_cross_transformed(first, last, chunk_out, tr_function,
+                                                                  max_distance, direction);
+                                       });
+    }
+
+    namespace detail
+    {
+        /// f is typically expensive when its roots are refined, so smaller chunks are worth a thread
+        constexpr std::ptrdiff_t min_parallel_root_chunk_size = 64;
+    }
+
+    /// \brief same as zero_cross_roots, on n_threads threads
+    /// \param n_threads 0 means one thread per hardware thread
+    ///
+    /// The grid is split in chunks of at least detail::min_parallel_root_chunk_size points,
+    /// each sampled and refined on its own thread, so f is called concurrently from several threads.
+    /// The roots are written in the order of the grid.
+    template<typename OutputIterator, typename RandomAccessIterator, typename Function>
+    void zero_cross_roots_parallel (RandomAccessIterator x_begin,
+                                    RandomAccessIterator x_end,
+                                    OutputIterator out,
+                                    unsigned n_threads,
+                                    Function f,
+                                    double x_tolerance = 0,
+                                    int direction = 0)
+    {
+      detail::zero_cross_parallel_impl(x_begin, x_end, out, n_threads,
+                                       [f, x_tolerance, direction] (auto first, auto last, auto chunk_out)
+                                       { zero_cross_roots(first, last, chunk_out, f, x_tolerance, direction); },
+                                       detail::min_parallel_root_chunk_size);
+    }
+
 }
 
 #endif //MYUTILITIES_ZERO_CROSSING_HPP
@@ -2,52 +2,324 @@
 // Created by Panagiotis Zestanakis on 26/02/19.
 //
 
-#include <iostream>
-#include <sstream>
-
-#include <boost/range/adaptors.hpp>
-#include <boost/range/algorithm_ext/push_back.hpp>
-#include <boost/range/algorithm/copy.hpp>
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <istream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
 #include "data_reading.hpp"
+#include "mapped_file.hpp"
+#include "number_scanner.hpp"
 
 namespace PanosUtilities
 {
 
+    std::string trimm_comments (const std::string& input, const std::string& comment_characters)
+    {
+
+        const auto pos = input.find_first_of(comment_characters);
+
+        return input.substr(0,pos);
+
+    }
+
+
+    std::vector<double> doubles_from_string (std::string_view string)
+    {
+        std::vector<double> output;
+
+        doubles_from_string(string, output);
+
+        return output;
+
+    }
+
+    std::size_t doubles_from_string (std::string_view string, std::vector<double>& output)
+    {
+        return detail::for_each_number(string.data(), string.data() + string.size(),
+                                       [&output] (double x)
+                                       { output.push_back(x); });
+    }
+
+
     namespace
     {
-        const auto float_regex =
-            boost::regex(R"(((\+|-)?[[:digit:]]+)(\.(([[:digit:]]+)?))?((e|E)((\+|-)?)[[:digit:]]+)?)");
+        /// appends the rows found in text to values and row_offsets, skipping lines without numbers
+        void append_table_rows (std::string_view text,
+                                std::string_view comment_characters,
+                                std::vector<double>& values,
+                                std::vector<std::size_t>& row_offsets)
+        {
+          const auto push_value = [&values] (double x)
+          { values.push_back(x); };
+
+          while (!text.empty())
+            {
+              const auto eol = text.find('\n');
+              auto line = text.substr(0, eol);
+              text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
 
+              line = line.substr(0, line.find_first_of(comment_characters));
+
+              if (detail::for_each_number(line.data(), line.data() + line.size(), push_value) != 0)
+                row_offsets.push_back(values.size());
+            }
+        }
     }
 
-    std::string trimm_comments (const std::string& input, const std::string& comment_characters)
+    NumericTable::NumericTable (std::vector<double> values,
+                                std::vector<std::size_t> row_offsets,
+                                StorageOrder order)
+        : values_{std::move(values)}, row_offsets_{std::move(row_offsets)}, order_{order}
     {
+      if (rows() != 0)
+        {
+          columns_ = row_size(0);
+          for (std::size_t i = 1; i < rows(); ++i)
+            if (row_size(i) != columns_)
+              {
+                columns_ = 0;
+                break;
+              }
+        }
 
-        const auto pos = input.find_first_of(comment_characters);
+      if (order_ == StorageOrder::row_major)
+        return;
 
-        return input.substr(0,pos);
+      if (rows() != 0 && columns() == 0)
+        throw std::domain_error("NumericTable: column major order requires rows of equal size");
+
+      const auto n_rows = rows();
+      const auto n_columns = columns();
+
+      std::vector<double> transposed(values_.size());
+      for (std::size_t i = 0; i < n_rows; ++i)
+        for (std::size_t j = 0; j < n_columns; ++j)
+          transposed[j * n_rows + i] = values_[i * n_columns + j];
 
+      values_ = std::move(transposed);
     }
 
+    std::size_t NumericTable::rows () const noexcept
+    {
+      return row_offsets_.empty() ? 0 : row_offsets_.size() - 1;
+    }
 
-    inline double convertToDouble_No_Check(const std::string& s)
+    std::size_t NumericTable::columns () const noexcept
     {
-        std::istringstream i(s);
-        double x;
-        i>>x;
-        return x;
+      return columns_;
     }
 
+    std::size_t NumericTable::row_size (std::size_t row) const noexcept
+    {
+      return row_offsets_[row + 1] - row_offsets_[row];
+    }
 
-    std::vector<double> doubles_from_string (const std::string& string)
+    StorageOrder NumericTable::order () const noexcept
     {
-        std::vector<double> output;
+      return order_;
+    }
 
-        boost::push_back(output,string
-                                | boost::adaptors::tokenized(float_regex)
-                                |boost::adaptors::transformed(convertToDouble_No_Check) );
-        return output;
+    const std::vector<double>& NumericTable::values () const noexcept
+    {
+      return values_;
+    }
+
+    const std::vector<std::size_t>& NumericTable::row_offsets () const noexcept
+    {
+      return row_offsets_;
+    }
 
+    double NumericTable::operator() (std::size_t row, std::size_t column) const noexcept
+    {
+      if (order_ == StorageOrder::row_major)
+        return values_[row_offsets_[row] + column];
+
+      return values_[column * rows() + row];
+    }
+
+    namespace
+    {
+        /// bytes of text per thread below which parsing is faster than starting the thread
+        constexpr std::size_t min_parallel_chunk_size = 1 << 14;
+
+        struct TableChunk {
+          std::vector<double> values;
+          std::vector<std::size_t> row_offsets;
+        };
+
+        /// splits text in at most n_chunks pieces, each ending just after a newline (or at the end of text)
+        std::vector<std::string_view> newline_aligned_chunks (std::string_view text, std::size_t n_chunks)
+        {
+          std::vector<std::string_view> chunks;
+          const auto target_size = text.size() / n_chunks + 1;
+
+          while (!text.empty())
+            {
+              const auto eol = text.find('\n', std::min(target_size, text.size()) - 1);
+              const auto chunk_size = (eol == std::string_view::npos) ? text.size() : eol + 1;
+
+              chunks.push_back(text.substr(0, chunk_size));
+              text.remove_prefix(chunk_size);
+            }
+          return chunks;
+        }
+    }
+
+    NumericTable parse_numeric_table (std::string_view text,
+                                      StorageOrder order,
+                                      const std::string& comment_characters,
+                                      unsigned n_threads)
+    {
+      if (n_threads == 0)
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+      std::vector<double> values;
+      std::vector<std::size_t> row_offsets{0};
+
+      const auto n_chunks = std::min<std::size_t>(n_threads, text.size() / min_parallel_chunk_size);
+
+      if (n_chunks <= 1)
+        {
+          append_table_rows(text, comment_characters, values, row_offsets);
+          return NumericTable(std::move(values), std::move(row_offsets), order);
+        }
+
+      const auto parse_chunk = [&comment_characters] (std::string_view chunk)
+      {
+          TableChunk result;
+          append_table_rows(chunk, comment_characters, result.values, result.row_offsets);
+          return result;
+      };
+
+      std::vector<std::future<TableChunk>> futures;
+      for (const auto chunk : newline_aligned_chunks(text, n_chunks))
+        futures.push_back(std::async(std::launch::async, parse_chunk, chunk));
+
+      std::vector<TableChunk> chunks;
+      std::size_t n_values = 0;
+      std::size_t n_rows = 0;
+      for (auto& future : futures)
+        {
+          chunks.push_back(future.get());
+          n_values += chunks.back().values.size();
+          n_rows += chunks.back().row_offsets.size();
+        }
+
+      values.reserve(n_values);
+      row_offsets.reserve(n_rows + 1);
+      for (const auto& chunk : chunks)
+        {
+          const auto offset = values.size();
+          values.insert(values.end(), chunk.values.cbegin(), chunk.values.cend());
+          for (const auto row_end : chunk.row_offsets)
+            row_offsets.push_back(offset + row_end);
+        }
+
+      return NumericTable(std::move(values), std::move(row_offsets), order);
+    }
+
+    NumericTable read_numeric_table (const std::string& path,
+                                     StorageOrder order,
+                                     const std::string& comment_characters,
+                                     unsigned n_threads)
+    {
+      const detail::MappedFile file(path);
+
+      return parse_numeric_table(file.text(), order, comment_characters, n_threads);
+    }
+
+    NumericRowReader::NumericRowReader (std::istream& input,
+                                        std::string comment_characters,
+                                        std::size_t block_size)
+        : input_{input},
+          comment_characters_{std::move(comment_characters)},
+          buffer_(std::max(block_size, std::size_t{1}))
+    {}
+
+    bool NumericRowReader::next_line (std::string_view& line)
+    {
+      std::size_t search_from = line_begin_;
+
+      while (true)
+        {
+          const auto newline = std::find(buffer_.data() + search_from, buffer_.data() + data_end_, '\n');
+          const auto newline_position = static_cast<std::size_t>(newline - buffer_.data());
+
+          if (newline_position != data_end_)
+            {
+              line = std::string_view(buffer_.data() + line_begin_, newline_position - line_begin_);
+              line_begin_ = newline_position + 1;
+              return true;
+            }
+
+          if (input_exhausted_)
+            {
+              if (line_begin_ == data_end_)
+                return false;
+
+              line = std::string_view(buffer_.data() + line_begin_, data_end_ - line_begin_);
+              line_begin_ = data_end_;
+              return true;
+            }
+
+          //keep the incomplete line and refill the rest of the buffer
+          std::memmove(buffer_.data(), buffer_.data() + line_begin_, data_end_ - line_begin_);
+          data_end_ -= line_begin_;
+          line_begin_ = 0;
+          search_from = data_end_;
+
+          //a line longer than the buffer
+          if (data_end_ == buffer_.size())
+            buffer_.resize(2 * buffer_.size());
+
+          input_.read(buffer_.data() + data_end_, static_cast<std::streamsize>(buffer_.size() - data_end_));
+          const auto n_read = static_cast<std::size_t>(input_.gcount());
+          data_end_ += n_read;
+
+          if (n_read == 0 || !input_)
+            input_exhausted_ = true;
+        }
+    }
+
+    bool NumericRowReader::next ()
+    {
+      //the current row is kept intact, the other buffer holds the previous row which may now be discarded
+      auto& new_row = rows_[1 - current_row_];
+      const auto push_value = [&new_row] (double x)
+      { new_row.push_back(x); };
+
+      std::string_view line;
+      while (next_line(line))
+        {
+          line = line.substr(0, line.find_first_of(comment_characters_));
+
+          new_row.clear();
+          if (detail::for_each_number(line.data(), line.data() + line.size(), push_value) != 0)
+            {
+              current_row_ = 1 - current_row_;
+              return true;
+            }
+        }
+      return false;
+    }
+
+    NumericRowReader::Row NumericRowReader::row () const noexcept
+    {
+      const auto& current = rows_[current_row_];
+      return Row(current.data(), current.data() + current.size());
+    }
+
+    NumericRowReader::iterator NumericRowReader::begin ()
+    {
+      return next() ? iterator(this) : end();
+    }
+
+    NumericRowReader::iterator NumericRowReader::end () noexcept
+    {
+      return iterator();
     }
-}
\ No newline at end of file
+}
@@ -1,62 +1,285 @@
 //
 // Created by Panagiotis Zestanakis on 25/10/18.
 //
-#include<algorithm>
-#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 #include "interval.hpp"
 #include "linspace.hpp"
+#include "linspace_kernel.hpp"
+#include "multiversion.hpp"
 
 
 namespace PanosUtilities
 {
-    Interval::Interval (double a, double b) noexcept
+    template<typename T>
+    std::vector<T> uniform_samples (const BasicInterval<T>& interval, size_t numOfsamples)
     {
+      return basic_linspace(interval.min(), interval.max(), numOfsamples);
+    }
+
+    template<typename T>
+    std::vector<T> uniform_samples_exclude_min (const BasicInterval<T>& interval, size_t numOfsamples)
+    {
+      const T distance = interval.max() - interval.min();
+
+      const T min_increase_factor = distance / static_cast<T>(numOfsamples);
 
-      std::tie(min_, max_) = std::minmax(a, b);
+      const T new_min = interval.min() + min_increase_factor;
+
+      const BasicInterval<T> new_interval(new_min, interval.max());
+
+      return uniform_samples(new_interval, numOfsamples);
     }
 
-    double Interval::min () const noexcept
+    template<typename T>
+    std::vector<T> uniform_samples_exclude_max (const BasicInterval<T>& interval, size_t numOfsamples)
     {
-      return min_;
+      const T distance = interval.max() - interval.min();
+
+      const T max_decrease_factor = distance / static_cast<T>(numOfsamples);
+
+      const T new_max = interval.max() - max_decrease_factor;
+
+      const BasicInterval<T> new_interval(interval.min(), new_max);
+
+      return uniform_samples(new_interval, numOfsamples);
     }
-    double Interval::max () const noexcept
+
+    template<typename T>
+    void uniform_samples_into (const BasicInterval<T>& interval, T *first, T *last)
     {
-      return max_;
+      basic_linspace_into(interval.min(), interval.max(), first, last);
     }
 
-    bool is_inside (double x, const Interval& interval)
+    template<typename T>
+    void uniform_samples_exclude_min_into (const BasicInterval<T>& interval, T *first, T *last)
     {
-      return (x >= interval.min() && x <= interval.max());
+      // same precondition as uniform_samples_exclude_min, which goes through basic_linspace
+      if (last - first < 2)
+        throw std::domain_error("uniform_samples_exclude_min_into: number of samples must be greater than 1");
+
+      const T step = (interval.max() - interval.min()) / static_cast<T>(last - first);
+
+      detail::fill_uniform(first, last, interval.min(), step, T(1));
+      *(last - 1) = interval.max();
     }
 
-    std::vector<double> uniform_samples (const Interval& interval, size_t numOfsamples)
+    template<typename T>
+    void uniform_samples_exclude_max_into (const BasicInterval<T>& interval, T *first, T *last)
     {
-      return linspace(interval.min(), interval.max(), numOfsamples);
+      // same precondition as uniform_samples_exclude_max, which goes through basic_linspace
+      if (last - first < 2)
+        throw std::domain_error("uniform_samples_exclude_max_into: number of samples must be greater than 1");
+
+      const T step = (interval.max() - interval.min()) / static_cast<T>(last - first);
+
+      detail::fill_uniform(first, last, interval.min(), step, T(0));
     }
 
-    std::vector<double> uniform_samples_exclude_min (const Interval& interval, size_t numOfsamples)
+#define MYUTILITIES_INSTANTIATE_INTERVAL(T) \
+    template std::vector<T> uniform_samples (const BasicInterval<T>&, size_t); \
+    template std::vector<T> uniform_samples_exclude_min (const BasicInterval<T>&, size_t); \
+    template std::vector<T> uniform_samples_exclude_max (const BasicInterval<T>&, size_t); \
+    template void uniform_samples_into (const BasicInterval<T>&, T *, T *); \
+    template void uniform_samples_exclude_min_into (const BasicInterval<T>&, T *, T *); \
+    template void uniform_samples_exclude_max_into (const BasicInterval<T>&, T *, T *);
+
+    MYUTILITIES_INSTANTIATE_INTERVAL(float)
+    MYUTILITIES_INSTANTIATE_INTERVAL(double)
+    MYUTILITIES_INSTANTIATE_INTERVAL(long double)
+
+#undef MYUTILITIES_INSTANTIATE_INTERVAL
+
+    namespace
     {
-      const double distance = interval.max() - interval.min();
+        template<typename T>
+        MYUTILITIES_KERNEL bool inside (T x, T min, T max) noexcept
+        {
+          // & instead of &&, so that both comparisons are made and the loops have no branches
+          return (x >= min) & (x <= max);
+        }
 
-      const double min_increase_factor = distance / (numOfsamples);
+        /// one block of 64 points per word of the mask.
+        /// The comparisons are made in a separate pass, which vectorizes, and then packed into bits.
+        template<typename T>
+        MYUTILITIES_KERNEL void is_inside_kernel (T min, T max, const T *first, const T *last,
+                                                  std::uint64_t *mask) noexcept
+        {
+          constexpr std::size_t block_size = 64;
 
-      const double new_min = interval.min() + min_increase_factor;
+          const auto size = static_cast<std::size_t>(last - first);
+          std::size_t i = 0;
 
-      const Interval new_interval(new_min, interval.max());
+          for (; i + block_size <= size; i += block_size)
+            {
+              unsigned char block[block_size];
+              for (std::size_t k = 0; k < block_size; ++k)
+                block[k] = inside(first[i + k], min, max);
 
-      return uniform_samples(new_interval, numOfsamples);
+              std::uint64_t word = 0;
+              for (std::size_t k = 0; k < block_size; ++k)
+                word |= std::uint64_t{block[k]} << k;
+              *mask++ = word;
+            }
+
+          if (i < size)
+            {
+              std::uint64_t word = 0;
+              for (std::size_t k = 0; i + k < size; ++k)
+                word |= std::uint64_t{inside(first[i + k], min, max)} << k;
+              *mask = word;
+            }
+        }
+
+        template<typename T>
+        MYUTILITIES_KERNEL std::size_t count_inside_kernel (T min, T max, const T *first, const T *last) noexcept
+        {
+          constexpr std::size_t block_size = 64;
+
+          const auto size = static_cast<std::size_t>(last - first);
+          std::size_t i = 0;
+          std::size_t count = 0;
+
+          for (; i + block_size <= size; i += block_size)
+            {
+              unsigned block_count = 0;
+              for (std::size_t k = 0; k < block_size; ++k)
+                block_count += inside(first[i + k], min, max);
+              count += block_count;
+            }
+
+          for (; i < size; ++i)
+            count += inside(first[i], min, max);
+
+          return count;
+        }
+
+        /// see wrap_kernel in wrap.cpp for the local buffer
+        template<typename T>
+        MYUTILITIES_KERNEL void clamp_kernel (T min, T max, const T *first, const T *last, T *d_first) noexcept
+        {
+          constexpr std::size_t block_size = 16;
+
+          const auto size = static_cast<std::size_t>(last - first);
+          std::size_t i = 0;
+
+          for (; i + block_size <= size; i += block_size)
+            {
+              T block[block_size];
+              for (std::size_t k = 0; k < block_size; ++k)
+                block[k] = first[i + k] < min ? min : (max < first[i + k] ? max : first[i + k]);
+              for (std::size_t k = 0; k < block_size; ++k)
+                d_first[i + k] = block[k];
+            }
+
+          for (; i < size; ++i)
+            d_first[i] = first[i] < min ? min : (max < first[i] ? max : first[i]);
+        }
+
+        /// block partition, as in Edelkamp and Weiss, "BlockQuicksort: Avoiding Branch Mispredictions in Quicksort".
+        ///
+        /// A block is scanned from each end, recording without branches the offsets of the points on the wrong side,
+        /// and then the misplaced points are swapped in pairs.
+        /// The remaining points, less than three blocks, are partitioned by std::partition.
+        template<typename T>
+        MYUTILITIES_KERNEL T *partition_inside_kernel (T min, T max, T *first, T *last) noexcept
+        {
+          constexpr int block_size = 64;
+
+          unsigned char offsets_left[block_size];
+          unsigned char offsets_right[block_size];
+          int start_left = 0, num_left = 0;
+          int start_right = 0, num_right = 0;
+
+          while (last - first > 2 * block_size)
+            {
+              if (num_left == 0)
+                {
+                  start_left = 0;
+                  for (int k = 0; k < block_size; ++k)
+                    {
+                      offsets_left[num_left] = static_cast<unsigned char>(k);
+                      num_left += !inside(first[k], min, max);
+                    }
+                }
+
+              if (num_right == 0)
+                {
+                  start_right = 0;
+                  for (int k = 0; k < block_size; ++k)
+                    {
+                      offsets_right[num_right] = static_cast<unsigned char>(k);
+                      num_right += inside(*(last - 1 - k), min, max);
+                    }
+                }
+
+              const int num = std::min(num_left, num_right);
+              for (int k = 0; k < num; ++k)
+                std::swap(first[offsets_left[start_left + k]], *(last - 1 - offsets_right[start_right + k]));
+
+              num_left -= num;
+              num_right -= num;
+              start_left += num;
+              start_right += num;
+
+              if (num_left == 0)
+                first += block_size;
+              if (num_right == 0)
+                last -= block_size;
+            }
+
+          return std::partition(first, last, [=] (T x)
+          { return inside(x, min, max); });
+        }
+    }
+
+    MYUTILITIES_MULTIVERSION
+    void is_inside_batch (const Interval& interval, const double *first, const double *last,
+                          std::uint64_t *mask) noexcept
+    {
+      is_inside_kernel(interval.min(), interval.max(), first, last, mask);
+    }
+
+    MYUTILITIES_MULTIVERSION
+    void is_inside_batch (const BasicInterval<float>& interval, const float *first, const float *last,
+                          std::uint64_t *mask) noexcept
+    {
+      is_inside_kernel(interval.min(), interval.max(), first, last, mask);
     }
 
-    std::vector<double> uniform_samples_exclude_max (const Interval& interval, size_t numOfsamples)
+    MYUTILITIES_MULTIVERSION
+    std::size_t count_inside (const Interval& interval, const double *first, const double *last) noexcept
     {
-      const double distance = interval.max() - interval.min();
+      return count_inside_kernel(interval.min(), interval.max(), first, last);
+    }
 
-      const double max_decrease_factor = distance / (numOfsamples);
+    MYUTILITIES_MULTIVERSION
+    std::size_t count_inside (const BasicInterval<float>& interval, const float *first, const float *last) noexcept
+    {
+      return count_inside_kernel(interval.min(), interval.max(), first, last);
+    }
+
+    MYUTILITIES_MULTIVERSION
+    void clamp_batch (const Interval& interval, const double *first, const double *last, double *d_first) noexcept
+    {
+      clamp_kernel(interval.min(), interval.max(), first, last, d_first);
+    }
 
-      const double new_max = interval.max() - max_decrease_factor;
+    MYUTILITIES_MULTIVERSION
+    void clamp_batch (const BasicInterval<float>& interval, const float *first, const float *last,
+                      float *d_first) noexcept
+    {
+      clamp_kernel(interval.min(), interval.max(), first, last, d_first);
+    }
 
-      const Interval new_interval(interval.min(), new_max);
+    double *partition_inside (const Interval& interval, double *first, double *last) noexcept
+    {
+      return partition_inside_kernel(interval.min(), interval.max(), first, last);
+    }
 
-      return uniform_samples(new_interval, numOfsamples);
+    float *partition_inside (const BasicInterval<float>& interval, float *first, float *last) noexcept
+    {
+      return partition_inside_kernel(interval.min(), interval.max(), first, last);
     }
-}
\ No newline at end of file
+}
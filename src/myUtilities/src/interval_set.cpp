@@ -0,0 +1,124 @@
+#include <algorithm>
+#include "interval_set.hpp"
+
+
+namespace PanosUtilities
+{
+    namespace
+    {
+        /// number of elements of the sorted mins with value <= x, by a binary search without branches
+        template<typename T>
+        std::size_t upper_bound_branchless (const std::vector<T>& mins, T x) noexcept
+        {
+          if (mins.empty())
+            return 0;
+
+          // the number of steps depends only on the size, the comparison selects the next base without a branch
+          const T *base = mins.data();
+          for (std::size_t n = mins.size(); n > 1;)
+            {
+              const std::size_t half = n / 2;
+              base = base[half] <= x ? base + half : base;
+              n -= half;
+            }
+
+          return static_cast<std::size_t>(base - mins.data()) + (*base <= x);
+        }
+    }
+
+    template<typename T>
+    BasicIntervalSet<T>::BasicIntervalSet (const std::vector<BasicInterval<T>>& intervals)
+    {
+      auto sorted = intervals;
+      std::sort(sorted.begin(), sorted.end(), [] (const BasicInterval<T>& a, const BasicInterval<T>& b)
+      { return a.min() < b.min(); });
+
+      for (const auto& interval : sorted)
+        {
+          if (!maxs_.empty() && interval.min() <= maxs_.back())
+            maxs_.back() = std::max(maxs_.back(), interval.max());
+          else
+            {
+              mins_.push_back(interval.min());
+              maxs_.push_back(interval.max());
+            }
+        }
+    }
+
+    template<typename T>
+    bool BasicIntervalSet<T>::contains (T x) const noexcept
+    {
+      const auto index = upper_bound_branchless(mins_, x);
+      return index > 0 && x <= maxs_[index - 1];
+    }
+
+    template<typename T>
+    std::size_t BasicIntervalSet<T>::find (T x) const noexcept
+    {
+      const auto index = upper_bound_branchless(mins_, x);
+      return index > 0 && x <= maxs_[index - 1] ? index - 1 : size();
+    }
+
+    template<typename T>
+    void BasicIntervalSet<T>::contains_batch (const T *first, const T *last, std::uint64_t *mask) const noexcept
+    {
+      const auto size = static_cast<std::size_t>(last - first);
+
+      if (mins_.empty())
+        {
+          std::fill(mask, mask + is_inside_mask_size(size), std::uint64_t{0});
+          return;
+        }
+
+      constexpr std::size_t block_size = 64;
+
+      for (std::size_t i = 0; i < size; i += block_size)
+        {
+          const std::size_t block_end = std::min(size - i, block_size);
+          const T *points = first + i;
+
+          // the searches of a block advance together, one step at a time,
+          // so that the loads of different points are independent of each other
+          std::size_t bases[block_size] = {};
+          for (std::size_t n = mins_.size(); n > 1;)
+            {
+              const std::size_t half = n / 2;
+              for (std::size_t k = 0; k < block_end; ++k)
+                bases[k] = mins_[bases[k] + half] <= points[k] ? bases[k] + half : bases[k];
+              n -= half;
+            }
+
+          std::uint64_t word = 0;
+          for (std::size_t k = 0; k < block_end; ++k)
+            {
+              const std::size_t index = bases[k] + (mins_[bases[k]] <= points[k]);
+              const bool inside = index > 0 && points[k] <= maxs_[index - 1];
+              word |= std::uint64_t{inside} << k;
+            }
+          mask[i / block_size] = word;
+        }
+    }
+
+    template<typename T>
+    void BasicIntervalSet<T>::contains_sorted_batch (const T *first, const T *last,
+                                                     std::uint64_t *mask) const noexcept
+    {
+      const auto size = static_cast<std::size_t>(last - first);
+      std::fill(mask, mask + is_inside_mask_size(size), std::uint64_t{0});
+
+      std::size_t j = 0;
+      for (std::size_t i = 0; i < size; ++i)
+        {
+          while (j < maxs_.size() && maxs_[j] < first[i])
+            ++j;
+          if (j == maxs_.size())
+            return;
+
+          mask[i / 64] |= std::uint64_t{mins_[j] <= first[i]} << (i % 64);
+        }
+    }
+
+    template class BasicIntervalSet<float>;
+    template class BasicIntervalSet<double>;
+    template class BasicIntervalSet<long double>;
+}
@@ -7,13 +7,16 @@
 
 
 #include "linspace.hpp"
+#include "linspace_kernel.hpp"
+#include "multiversion.hpp"
 
 namespace PanosUtilities
 {
 
-    std::vector<double> linspace (double begin, double end, size_t numOfsamples)
+    template<typename T>
+    std::vector<T> basic_linspace (T begin, T end, size_t numOfsamples)
     {
-      std::vector<double> output;
+      std::vector<T> output;
       output.reserve(numOfsamples);
 
       if (numOfsamples < 2)
@@ -21,11 +24,84 @@ namespace PanosUtilities
 
       auto cRange = boost::counting_range(static_cast<size_t >(0), numOfsamples);
 
-      auto transform = [begin, end, numOfsamples] (int i)
-      { return begin + i * (end - begin) / (numOfsamples - 1); };
+      auto transform = [begin, end, numOfsamples] (size_t i)
+      { return begin + static_cast<T>(i) * (end - begin) / static_cast<T>(numOfsamples - 1); };
 
       boost::push_back(output, cRange | boost::adaptors::transformed(transform));
 
       return output;
     }
-}
\ No newline at end of file
+
+    template std::vector<float> basic_linspace (float, float, size_t);
+    template std::vector<double> basic_linspace (double, double, size_t);
+    template std::vector<long double> basic_linspace (long double, long double, size_t);
+
+    std::vector<double> linspace (double begin, double end, size_t numOfsamples)
+    {
+      return basic_linspace(begin, end, numOfsamples);
+    }
+
+    namespace detail
+    {
+        template<typename T>
+        MYUTILITIES_KERNEL void fill_uniform_kernel (T *first, T *last, T origin, T step, T offset) noexcept
+        {
+          //blocks with an int counter, so that the index to floating point conversion vectorizes
+          constexpr int block_size = 16;
+
+          const auto size = static_cast<std::size_t>(last - first);
+          std::size_t i = 0;
+
+          for (; i + block_size <= size; i += block_size)
+            {
+              const T block_origin = static_cast<T>(i) + offset;
+              for (int k = 0; k < block_size; ++k)
+                first[i + static_cast<std::size_t>(k)] = origin + (block_origin + static_cast<T>(k)) * step;
+            }
+
+          for (; i < size; ++i)
+            first[i] = origin + (static_cast<T>(i) + offset) * step;
+        }
+
+        MYUTILITIES_MULTIVERSION
+        void fill_uniform (float *first, float *last, float origin, float step, float offset) noexcept
+        {
+          fill_uniform_kernel(first, last, origin, step, offset);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        void fill_uniform (double *first, double *last, double origin, double step, double offset) noexcept
+        {
+          fill_uniform_kernel(first, last, origin, step, offset);
+        }
+
+        void fill_uniform (long double *first, long double *last, long double origin, long double step,
+                           long double offset) noexcept
+        {
+          fill_uniform_kernel(first, last, origin, step, offset);
+        }
+    }
+
+    template<typename T>
+    void basic_linspace_into (T begin, T end, T *first, T *last)
+    {
+      const auto numOfsamples = static_cast<std::size_t>(last - first);
+
+      if (numOfsamples < 2)
+        throw std::domain_error("linspace_into: number of samples must be greater than 1");
+
+      const T step = (end - begin) / static_cast<T>(numOfsamples - 1);
+
+      detail::fill_uniform(first, last, begin, step, T(0));
+      *(last - 1) = end;
+    }
+
+    template void basic_linspace_into (float, float, float *, float *);
+    template void basic_linspace_into (double, double, double *, double *);
+    template void basic_linspace_into (long double, long double, long double *, long double *);
+
+    void linspace_into (double begin, double end, double *first, double *last)
+    {
+      basic_linspace_into(begin, end, first, last);
+    }
+}
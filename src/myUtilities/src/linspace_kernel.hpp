@@ -0,0 +1,18 @@
+#ifndef MYUTILITIES_LINSPACE_KERNEL_HPP
+#define MYUTILITIES_LINSPACE_KERNEL_HPP
+
+namespace PanosUtilities
+{
+    namespace detail
+    {
+        /// \brief writes origin + (i + offset) * step to first[i], for every i in [0, last - first)
+        void fill_uniform (float *first, float *last, float origin, float step, float offset) noexcept;
+
+        void fill_uniform (double *first, double *last, double origin, double step, double offset) noexcept;
+
+        void fill_uniform (long double *first, long double *last, long double origin, long double step,
+                           long double offset) noexcept;
+    }
+}
+
+#endif //MYUTILITIES_LINSPACE_KERNEL_HPP
@@ -0,0 +1,59 @@
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.hpp"
+
+namespace PanosUtilities
+{
+    namespace detail
+    {
+        MappedFile::MappedFile (const std::string& path)
+        {
+          const int fd = ::open(path.c_str(), O_RDONLY);
+          if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "MappedFile: cannot open " + path);
+
+          struct stat file_status{};
+          if (::fstat(fd, &file_status) != 0)
+            {
+              const int error = errno;
+              ::close(fd);
+              throw std::system_error(error, std::generic_category(), "MappedFile: cannot stat " + path);
+            }
+
+          size_ = static_cast<std::size_t>(file_status.st_size);
+
+          //mapping an empty file is an error, there is nothing to map anyway
+          if (size_ != 0)
+            {
+              void *address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+              if (address == MAP_FAILED)
+                {
+                  const int error = errno;
+                  ::close(fd);
+                  throw std::system_error(error, std::generic_category(), "MappedFile: cannot map " + path);
+                }
+              ::madvise(address, size_, MADV_SEQUENTIAL);
+              data_ = static_cast<const char *>(address);
+            }
+
+          ::close(fd);
+        }
+
+        MappedFile::~MappedFile ()
+        {
+          if (data_)
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+
+        std::string_view MappedFile::text () const noexcept
+        {
+          return std::string_view(data_, size_);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef MYUTILITIES_MAPPED_FILE_HPP
+#define MYUTILITIES_MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+
+namespace PanosUtilities
+{
+    namespace detail
+    {
+        /// \brief read only memory mapping of a whole file
+        ///
+        /// throws std::system_error if the file cannot be opened or mapped
+        class MappedFile {
+          const char *data_{nullptr};
+          std::size_t size_{0};
+         public:
+          explicit MappedFile (const std::string& path);
+          ~MappedFile ();
+          MappedFile (const MappedFile&) = delete;
+          MappedFile& operator= (const MappedFile&) = delete;
+
+          std::string_view text () const noexcept;
+        };
+    }
+}
+
+#endif //MYUTILITIES_MAPPED_FILE_HPP
@@ -0,0 +1,21 @@
+#ifndef MYUTILITIES_MULTIVERSION_HPP
+#define MYUTILITIES_MULTIVERSION_HPP
+
+/// MYUTILITIES_MULTIVERSION compiles a function once per instruction set and picks the best one at load time.
+///
+/// Functions marked with it should contain loops simple enough for the compiler to vectorize.
+/// Where ifunc is not available, the function is compiled once for the target given on the command line.
+/// The kernels they call must be marked MYUTILITIES_KERNEL, so that they are compiled inside each version.
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+#define MYUTILITIES_MULTIVERSION __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define MYUTILITIES_MULTIVERSION
+#endif
+
+#if defined(__GNUC__)
+#define MYUTILITIES_KERNEL inline __attribute__((always_inline))
+#else
+#define MYUTILITIES_KERNEL inline
+#endif
+
+#endif //MYUTILITIES_MULTIVERSION_HPP
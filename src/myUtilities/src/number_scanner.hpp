@@ -0,0 +1,108 @@
+#ifndef MYUTILITIES_NUMBER_SCANNER_HPP
+#define MYUTILITIES_NUMBER_SCANNER_HPP
+
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+
+namespace PanosUtilities
+{
+    namespace detail
+    {
+        inline bool is_digit (char c) noexcept
+        {
+          return c >= '0' && c <= '9';
+        }
+
+        inline bool is_sign (char c) noexcept
+        {
+          return c == '+' || c == '-';
+        }
+
+        inline const char *skip_digits (const char *first, const char *last) noexcept
+        {
+          while (first != last && is_digit(*first))
+            ++first;
+          return first;
+        }
+
+        /// \brief finds the leftmost number in [first, last)
+        /// \param first
+        /// \param last
+        /// \param token_begin set to the first character of the number, or to last if there is none
+        /// \return pointer past the last character of the number, or last if there is none
+        ///
+        /// A number is anything matching [+-]?[0-9]+(\.[0-9]*)?([eE][+-]?[0-9]+)?
+        inline const char *find_number (const char *first, const char *last, const char *& token_begin) noexcept
+        {
+          const char *p = first;
+          while (p != last && !is_digit(*p))
+            ++p;
+
+          if (p == last)
+            {
+              token_begin = last;
+              return last;
+            }
+
+          token_begin = (p != first && is_sign(*(p - 1))) ? p - 1 : p;
+
+          p = skip_digits(p, last);
+
+          if (p != last && *p == '.')
+            p = skip_digits(p + 1, last);
+
+          if (p != last && (*p == 'e' || *p == 'E'))
+            {
+              const char *exponent = p + 1;
+              if (exponent != last && is_sign(*exponent))
+                ++exponent;
+              if (exponent != last && is_digit(*exponent))
+                p = skip_digits(exponent, last);
+            }
+
+          return p;
+        }
+
+        /// \brief converts a token located by find_number
+        inline double token_to_double (const char *first, const char *last)
+        {
+          const char *digits = (*first == '+') ? first + 1 : first;
+
+          double value = 0;
+          const auto result = std::from_chars(digits, last, value);
+
+          if (result.ec == std::errc::result_out_of_range)
+            {
+              const std::string token(first, last);
+              return std::strtod(token.c_str(), nullptr);
+            }
+
+          return value;
+        }
+
+        /// \brief calls fn(value) for every number in [first, last)
+        /// \return the number of values found
+        template<typename Function>
+        std::size_t for_each_number (const char *first, const char *last, Function fn)
+        {
+          std::size_t count = 0;
+          const char *token_begin = first;
+
+          while (true)
+            {
+              const char *token_end = find_number(first, last, token_begin);
+              if (token_begin == last)
+                break;
+
+              fn(token_to_double(token_begin, token_end));
+              ++count;
+              first = token_end;
+            }
+          return count;
+        }
+    }
+}
+
+#endif //MYUTILITIES_NUMBER_SCANNER_HPP
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+#include <boost/endian/conversion.hpp>
+
+#include "data_reading.hpp"
+#include "mapped_file.hpp"
+
+namespace PanosUtilities
+{
+    namespace
+    {
+        constexpr char cache_magic[8] = {'P', 'U', 'T', 'A', 'B', 'L', 'E', '\0'};
+        constexpr std::uint64_t cache_version = 2;
+
+        struct CacheHeader {
+          char magic[8];
+          std::uint64_t version;
+          std::uint64_t value_size;
+          std::uint64_t source_size;
+          std::int64_t source_mtime;
+          std::uint64_t comment_characters_checksum;
+          std::uint64_t rows;
+          std::uint64_t n_values;
+        };
+
+        static_assert(sizeof(CacheHeader) == 64, "CacheHeader must not contain padding");
+
+        /// 64 bit FNV-1a, of the comment characters
+        std::uint64_t checksum (std::string_view text) noexcept
+        {
+          std::uint64_t hash = 14695981039346656037ull;
+          for (const char c : text)
+            {
+              hash ^= static_cast<unsigned char>(c);
+              hash *= 1099511628211ull;
+            }
+          return hash;
+        }
+
+        struct SourceStatus {
+          std::uint64_t size;
+          std::int64_t mtime;
+        };
+
+        SourceStatus source_status (const std::string& path)
+        {
+          const auto size = std::filesystem::file_size(path);
+          const auto mtime = std::filesystem::last_write_time(path).time_since_epoch().count();
+          return {static_cast<std::uint64_t>(size), static_cast<std::int64_t>(mtime)};
+        }
+
+        template<typename T>
+        void copy_array (const char *source, std::vector<T>& destination, std::size_t n)
+        {
+          destination.resize(n);
+          std::memcpy(destination.data(), source, destination.size() * sizeof(T));
+        }
+
+        /// \return false if cache_path does not exist, cannot be read or does not match the source
+        bool load_cache (const std::string& cache_path,
+                         const SourceStatus& source,
+                         std::uint64_t comment_characters_checksum,
+                         std::vector<double>& values,
+                         std::vector<std::size_t>& row_offsets)
+        {
+          std::error_code error;
+          if (!std::filesystem::exists(cache_path, error))
+            return false;
+
+          //a cache that cannot be opened or mapped, e.g. a directory, is as good as a missing one
+          std::optional<detail::MappedFile> cache;
+          try
+            {
+              cache.emplace(cache_path);
+            }
+          catch (const std::system_error&)
+            {
+              return false;
+            }
+          const auto data = cache->text();
+
+          CacheHeader header{};
+          if (data.size() < sizeof(header))
+            return false;
+          std::memcpy(&header, data.data(), sizeof(header));
+
+          const bool header_matches = std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) == 0
+                                      && header.version == cache_version
+                                      && header.value_size == sizeof(double)
+                                      && header.source_size == source.size
+                                      && header.source_mtime == source.mtime
+                                      && header.comment_characters_checksum == comment_characters_checksum;
+
+          if (!header_matches)
+            return false;
+
+          //the header is not trusted, bound its sizes by the file size before multiplying
+          const auto max_elements = data.size() / sizeof(std::uint64_t);
+          if (header.rows >= max_elements || header.n_values > max_elements)
+            return false;
+
+          const auto offsets_size = (header.rows + 1) * sizeof(std::uint64_t);
+          const auto values_size = header.n_values * sizeof(double);
+
+          if (data.size() != sizeof(header) + offsets_size + values_size)
+            return false;
+
+          const char *offsets_begin = data.data() + sizeof(header);
+
+          std::vector<std::uint64_t> offsets;
+          copy_array(offsets_begin, offsets, header.rows + 1);
+
+          //row_size of NumericTable relies on non decreasing offsets from 0 to the number of values
+          if (offsets.front() != 0 || offsets.back() != header.n_values
+              || !std::is_sorted(offsets.cbegin(), offsets.cend()))
+            return false;
+
+          row_offsets.assign(offsets.cbegin(), offsets.cend());
+          copy_array(offsets_begin + offsets_size, values, header.n_values);
+
+          return true;
+        }
+
+        /// \brief a file name next to path, distinct for every process and call
+        ///
+        /// Processes writing the same cache at the same time then never truncate each other's temporary file,
+        /// the last rename wins.
+        std::string unique_temporary_path (const std::string& path)
+        {
+          std::random_device device;
+          return path + "." + std::to_string(::getpid()) + "." + std::to_string(device()) + ".tmp";
+        }
+
+        void write_cache (const std::string& cache_path,
+                          const SourceStatus& source,
+                          std::uint64_t comment_characters_checksum,
+                          const NumericTable& table)
+        {
+          CacheHeader header{};
+          std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+          header.version = cache_version;
+          header.value_size = sizeof(double);
+          header.source_size = source.size;
+          header.source_mtime = source.mtime;
+          header.comment_characters_checksum = comment_characters_checksum;
+          header.rows = table.rows();
+          header.n_values = table.values().size();
+
+          const std::vector<std::uint64_t> offsets(table.row_offsets().cbegin(), table.row_offsets().cend());
+
+          const auto write_bytes = [] (std::ofstream& os, const void *data, std::size_t size)
+          {
+              os.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+          };
+
+          //write to a temporary file first, so that a crash never leaves a truncated cache behind
+          const auto temporary_path = unique_temporary_path(cache_path);
+          std::error_code error;
+          {
+            std::ofstream os(temporary_path, std::ios::binary | std::ios::trunc);
+            write_bytes(os, &header, sizeof(header));
+            write_bytes(os, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+            write_bytes(os, table.values().data(), table.values().size() * sizeof(double));
+            os.close();
+            if (!os)
+              {
+                std::filesystem::remove(temporary_path, error);
+                return;
+              }
+          }
+
+          std::filesystem::rename(temporary_path, cache_path, error);
+          if (error)
+            std::filesystem::remove(temporary_path, error);
+        }
+    }
+
+    NumericTable read_numeric_table_cached (const std::string& path,
+                                            const std::string& cache_path,
+                                            StorageOrder order,
+                                            const std::string& comment_characters,
+                                            unsigned n_threads)
+    {
+      //the cache stores raw little endian data
+      if constexpr (boost::endian::order::native != boost::endian::order::little)
+        return read_numeric_table(path, order, comment_characters, n_threads);
+
+      const auto source = source_status(path);
+      const auto comment_characters_checksum = checksum(comment_characters);
+
+      std::vector<double> values;
+      std::vector<std::size_t> row_offsets;
+
+      //the cache is copied out of the mapping, NumericTable cannot refer to memory it does not own
+      if (load_cache(cache_path, source, comment_characters_checksum, values, row_offsets))
+        return NumericTable(std::move(values), std::move(row_offsets), order);
+
+      const detail::MappedFile file(path);
+      auto table = parse_numeric_table(file.text(), StorageOrder::row_major, comment_characters, n_threads);
+
+      write_cache(cache_path, source, comment_characters_checksum, table);
+
+      if (order == StorageOrder::row_major)
+        return table;
+
+      return NumericTable(table.values(), table.row_offsets(), order);
+    }
+}
@@ -2,30 +2,371 @@
 // Created by Panagiotis Zestanakis on 25/10/18.
 //
 
-#include <boost/math/constants/constants.hpp>
-
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <future>
+#include <thread>
+#include <vector>
+#include "wrap.hpp"
+#include "multiversion.hpp"
 
 
 namespace PanosUtilities
 {
+    namespace
+    {
+        /// applies wrap to [first, last), block by block through a local buffer,
+        /// so that the compiler needs no aliasing checks between input and output to vectorize.
+        /// std::floor is only vectorized without -ftrapping-math, see CMakeLists.txt
+        template<typename T, typename Wrap>
+        MYUTILITIES_KERNEL void wrap_kernel (const T *first, const T *last, T *d_first, Wrap wrap) noexcept
+        {
+          constexpr std::size_t block_size = 16;
+
+          const auto size = static_cast<std::size_t>(last - first);
+          std::size_t i = 0;
+
+          for (; i + block_size <= size; i += block_size)
+            {
+              T block[block_size];
+              for (std::size_t k = 0; k < block_size; ++k)
+                block[k] = wrap(first[i + k]);
+              for (std::size_t k = 0; k < block_size; ++k)
+                d_first[i + k] = block[k];
+            }
+
+          for (; i < size; ++i)
+            d_first[i] = wrap(first[i]);
+        }
+
+        /// like wrap_kernel, for wraps that are repeated max_periods times.
+        /// The repetitions are separate passes over the block, so that each pass vectorizes.
+        template<typename T, typename WrapStep>
+        MYUTILITIES_KERNEL void wrap_near_kernel (const T *first, const T *last, T *d_first, int max_periods,
+                                                  WrapStep wrap_step) noexcept
+        {
+          constexpr std::size_t block_size = 16;
 
+          const auto size = static_cast<std::size_t>(last - first);
+          std::size_t i = 0;
 
+          for (; i + block_size <= size; i += block_size)
+            {
+              T block[block_size];
+              for (std::size_t k = 0; k < block_size; ++k)
+                block[k] = first[i + k];
+              for (int period = 0; period < max_periods; ++period)
+                for (std::size_t k = 0; k < block_size; ++k)
+                  block[k] = wrap_step(block[k]);
+              for (std::size_t k = 0; k < block_size; ++k)
+                d_first[i + k] = block[k];
+            }
 
-    double wrap_2pi (double angle) noexcept
+          for (; i < size; ++i)
+            {
+              T angle = first[i];
+              for (int period = 0; period < max_periods; ++period)
+                angle = wrap_step(angle);
+              d_first[i] = angle;
+            }
+        }
+    }
+
+    MYUTILITIES_MULTIVERSION
+    void wrap_2pi_batch (const double *first, const double *last, double *d_first) noexcept
     {
-      using boost::math::double_constants::one_div_two_pi;
-      using boost::math::double_constants::two_pi;
+      wrap_kernel(first, last, d_first, [] (double angle) { return wrap_2pi(angle); });
+    }
 
+    MYUTILITIES_MULTIVERSION
+    void wrap_minus_pi_pi_batch (const double *first, const double *last, double *d_first) noexcept
+    {
+      wrap_kernel(first, last, d_first, [] (double angle) { return wrap_minus_pi_pi(angle); });
+    }
 
+    MYUTILITIES_MULTIVERSION
+    void wrap_2pi_batch (const float *first, const float *last, float *d_first) noexcept
+    {
+      wrap_kernel(first, last, d_first, [] (float angle) { return basic_wrap_2pi(angle); });
+    }
 
-      return angle - two_pi * floor(angle *one_div_two_pi);
+    MYUTILITIES_MULTIVERSION
+    void wrap_minus_pi_pi_batch (const float *first, const float *last, float *d_first) noexcept
+    {
+      wrap_kernel(first, last, d_first, [] (float angle) { return basic_wrap_minus_pi_pi(angle); });
     }
 
+    namespace
+    {
+        /// one period of basic_wrap_2pi_near, for the vectorized batch path.
+        /// Selects of T, unlike the int conversions of the scalar path in the header, become vector blends
+        /// when trapping math is off. The results are the same.
+        template<typename T>
+        MYUTILITIES_KERNEL T wrap_2pi_near_step (T angle) noexcept
+        {
+          constexpr T two_pi = boost::math::constants::two_pi<T>();
+
+          angle += angle < 0 ? two_pi : T(0);
+          return angle - (angle >= two_pi ? two_pi : T(0));
+        }
 
-    double wrap_minus_pi_pi (double angle) noexcept
+        /// one period of basic_wrap_minus_pi_pi_near, see wrap_2pi_near_step
+        template<typename T>
+        MYUTILITIES_KERNEL T wrap_minus_pi_pi_near_step (T angle) noexcept
+        {
+          constexpr T pi = boost::math::constants::pi<T>();
+          constexpr T two_pi = boost::math::constants::two_pi<T>();
+
+          angle += angle < -pi ? two_pi : T(0);
+          return angle - (angle >= pi ? two_pi : T(0));
+        }
+    }
+
+    MYUTILITIES_MULTIVERSION
+    void wrap_2pi_near_batch (const double *first, const double *last, double *d_first, int max_periods) noexcept
     {
-      using boost::math::double_constants::pi;
+      wrap_near_kernel(first, last, d_first, max_periods, wrap_2pi_near_step<double>);
+    }
+
+    MYUTILITIES_MULTIVERSION
+    void wrap_2pi_near_batch (const float *first, const float *last, float *d_first, int max_periods) noexcept
+    {
+      wrap_near_kernel(first, last, d_first, max_periods, wrap_2pi_near_step<float>);
+    }
+
+    MYUTILITIES_MULTIVERSION
+    void wrap_minus_pi_pi_near_batch (const double *first, const double *last, double *d_first,
+                                      int max_periods) noexcept
+    {
+      wrap_near_kernel(first, last, d_first, max_periods, wrap_minus_pi_pi_near_step<double>);
+    }
+
+    MYUTILITIES_MULTIVERSION
+    void wrap_minus_pi_pi_near_batch (const float *first, const float *last, float *d_first, int max_periods) noexcept
+    {
+      wrap_near_kernel(first, last, d_first, max_periods, wrap_minus_pi_pi_near_step<float>);
+    }
+
+    namespace
+    {
+        constexpr std::size_t unwrap_block_size = 64;
+
+        /// the prefix sum of the periods is skipped in sub blocks of this size without jumps
+        constexpr std::size_t unwrap_sub_block_size = 16;
+
+        template<typename T>
+        MYUTILITIES_KERNEL T unwrap_step (const T *angle, T *d_angle, T& previous, T periods) noexcept
+        {
+          const T value = *angle;
+          periods += detail::unwrap_periods(value - previous);
+          previous = value;
+          *d_angle = value + boost::math::constants::two_pi<T>() * periods;
+          return periods;
+        }
+
+        /// true if any of the periods is non zero. The periods are integers, so their bits are compared
+        /// instead, which vectorizes better than comparisons of floating point values
+        template<typename T>
+        MYUTILITIES_KERNEL bool has_jumps (const T *periods) noexcept
+        {
+          using Bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+
+          Bits mask = 0;
+          for (std::size_t k = 0; k < unwrap_sub_block_size; ++k)
+            {
+              Bits bits;
+              std::memcpy(&bits, periods + k, sizeof(T));
+              mask |= bits;
+            }
+          //the sign bit alone is -0
+          return static_cast<Bits>(mask << 1) != 0;
+        }
+
+        /// unwraps [first, last) given the angle before first and the periods added up to it.
+        /// Returns the periods added up to last.
+        template<typename T>
+        MYUTILITIES_KERNEL T unwrap_kernel (const T *first, const T *last, T *d_first, T previous, T periods) noexcept
+        {
+          constexpr T two_pi = boost::math::constants::two_pi<T>();
+
+          if (first == last)
+            return periods;
+
+          //from here on, the angle before each block is in [first, last), so it is read without a race
+          //even when another thread unwraps the chunk before this one in place
+          periods = unwrap_step(first, d_first, previous, periods);
+
+          const auto size = static_cast<std::size_t>(last - first);
+          std::size_t i = 1;
+
+          for (; i + unwrap_block_size <= size; i += unwrap_block_size)
+            {
+              T offsets[unwrap_block_size];
+              T block[unwrap_block_size];
+
+              //first[i - 1] may have been overwritten if unwrapping in place, the first lane is fixed below
+              for (std::size_t k = 0; k < unwrap_block_size; ++k)
+                offsets[k] = detail::unwrap_periods(first[i + k] - first[i + k - 1]);
+              offsets[0] = detail::unwrap_periods(first[i] - previous);
 
-      return wrap_2pi(angle + pi) - pi;
+              for (std::size_t sub = 0; sub < unwrap_block_size; sub += unwrap_sub_block_size)
+                if (has_jumps(offsets + sub))
+                  for (std::size_t k = sub; k < sub + unwrap_sub_block_size; ++k)
+                    {
+                      periods += offsets[k];
+                      offsets[k] = periods;
+                    }
+                else
+                  for (std::size_t k = sub; k < sub + unwrap_sub_block_size; ++k)
+                    offsets[k] = periods;
+
+              for (std::size_t k = 0; k < unwrap_block_size; ++k)
+                block[k] = first[i + k] + two_pi * offsets[k];
+
+              previous = first[i + unwrap_block_size - 1];
+
+              for (std::size_t k = 0; k < unwrap_block_size; ++k)
+                d_first[i + k] = block[k];
+            }
+
+          for (; i < size; ++i)
+            periods = unwrap_step(first + i, d_first + i, previous, periods);
+
+          return periods;
+        }
+
+        /// periods added by unwrap_kernel over [first, last), reading the angle before first too
+        template<typename T>
+        MYUTILITIES_KERNEL T unwrap_count_kernel (const T *first, const T *last) noexcept
+        {
+          const auto size = static_cast<std::size_t>(last - first);
+          std::size_t i = 0;
+
+          //one partial sum per lane, exact since the periods are integers
+          T partial_sums[unwrap_block_size] = {};
+
+          for (; i + unwrap_block_size <= size; i += unwrap_block_size)
+            for (std::size_t k = 0; k < unwrap_block_size; ++k)
+              partial_sums[k] += detail::unwrap_periods(first[i + k] - first[i + k - 1]);
+
+          T periods = 0;
+          for (auto partial_sum : partial_sums)
+            periods += partial_sum;
+
+          for (; i < size; ++i)
+            periods += detail::unwrap_periods(first[i] - first[i - 1]);
+
+          return periods;
+        }
+
+        MYUTILITIES_MULTIVERSION
+        double unwrap_chunk (const double *first, const double *last, double *d_first, double previous,
+                             double periods) noexcept
+        {
+          return unwrap_kernel(first, last, d_first, previous, periods);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        float unwrap_chunk (const float *first, const float *last, float *d_first, float previous,
+                            float periods) noexcept
+        {
+          return unwrap_kernel(first, last, d_first, previous, periods);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        double unwrap_count (const double *first, const double *last) noexcept
+        {
+          return unwrap_count_kernel(first, last);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        float unwrap_count (const float *first, const float *last) noexcept
+        {
+          return unwrap_count_kernel(first, last);
+        }
+
+        template<typename T>
+        void unwrap_batch_impl (const T *first, const T *last, T *d_first) noexcept
+        {
+          if (first == last)
+            return;
+
+          const T previous = *first;
+          *d_first = previous;
+          unwrap_chunk(first + 1, last, d_first + 1, previous, T(0));
+        }
+
+        /// as for zero_cross_parallel, shorter chunks are not worth a thread
+        constexpr std::ptrdiff_t min_unwrap_chunk_size = 1 << 14;
+
+        template<typename T>
+        void unwrap_parallel_impl (const T *first, const T *last, T *d_first, unsigned n_threads)
+        {
+          if (n_threads == 0)
+            n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+          const auto size = last - first;
+          const auto n_chunks = std::max(std::min<std::ptrdiff_t>(n_threads, size / min_unwrap_chunk_size),
+                                         std::ptrdiff_t{1});
+
+          if (n_chunks == 1)
+            return unwrap_batch_impl(first, last, d_first);
+
+          //chunk k covers [first + bounds[k], first + bounds[k+1]), the first angle is copied as it is
+          std::vector<std::ptrdiff_t> bounds(static_cast<std::size_t>(n_chunks) + 1);
+          for (std::ptrdiff_t k = 0; k <= n_chunks; ++k)
+            bounds[static_cast<std::size_t>(k)] = std::max(k * size / n_chunks, std::ptrdiff_t{1});
+
+          //saved before any output is written, d_first may be equal to first
+          std::vector<T> previous(static_cast<std::size_t>(n_chunks));
+          for (std::size_t k = 0; k < previous.size(); ++k)
+            previous[k] = first[bounds[k] - 1];
+
+          //nothing is written while counting, so each chunk may read the angle before it
+          std::vector<std::future<T>> counts;
+          for (std::size_t k = 0; k + 1 < previous.size(); ++k)
+            counts.push_back(std::async(std::launch::async, [=]
+            { return unwrap_count(first + bounds[k], first + bounds[k + 1]); }));
+
+          std::vector<T> periods(previous.size(), T(0));
+          for (std::size_t k = 0; k < counts.size(); ++k)
+            periods[k + 1] = periods[k] + counts[k].get();
+
+          *d_first = *first;
+
+          std::vector<std::future<T>> chunks;
+          for (std::size_t k = 0; k < previous.size(); ++k)
+            chunks.push_back(std::async(std::launch::async, [=, &previous, &periods]
+            {
+                return unwrap_chunk(first + bounds[k], first + bounds[k + 1], d_first + bounds[k],
+                                    previous[k], periods[k]);
+            }));
+
+          for (auto& chunk : chunks)
+            chunk.get();
+        }
+    }
+
+    void unwrap_batch (const double *first, const double *last, double *d_first) noexcept
+    {
+      unwrap_batch_impl(first, last, d_first);
+    }
+
+    void unwrap_batch (const float *first, const float *last, float *d_first) noexcept
+    {
+      unwrap_batch_impl(first, last, d_first);
+    }
+
+    void unwrap_parallel (const double *first, const double *last, double *d_first, unsigned n_threads)
+    {
+      unwrap_parallel_impl(first, last, d_first, n_threads);
+    }
+
+    void unwrap_parallel (const float *first, const float *last, float *d_first, unsigned n_threads)
+    {
+      unwrap_parallel_impl(first, last, d_first, n_threads);
     }
-}
\ No newline at end of file
+}
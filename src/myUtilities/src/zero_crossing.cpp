@@ -0,0 +1,233 @@
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "zero_crossing.hpp"
+#include "multiversion.hpp"
+
+namespace PanosUtilities
+{
+    namespace detail
+    {
+        namespace
+        {
+            /// \brief same as my_adjacent_find on [first, last), for a branchless predicate
+            ///
+            /// Pairs are tested in fixed size blocks without early exit, so that the compiler can vectorize the test.
+            /// The first block with a hit is then searched element by element.
+            template<typename T, typename BranchlessPredicate>
+            MYUTILITIES_KERNEL const T *adjacent_find_blockwise (const T *first, const T *last, BranchlessPredicate p) noexcept
+            {
+              using Mask = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+              constexpr std::size_t block_size = 256 / sizeof(T);
+
+              if (last - first < 2)
+                return last;
+
+              const auto n_pairs = static_cast<std::size_t>(last - first) - 1;
+
+              std::size_t i = 0;
+              for (; i + block_size <= n_pairs; i += block_size)
+                {
+                  Mask hits = 0;
+                  for (std::size_t k = 0; k < block_size; ++k)
+                    hits |= static_cast<Mask>(p(first[i + k], first[i + k + 1]));
+                  if (hits)
+                    break;
+                }
+
+              for (; i < n_pairs; ++i)
+                if (p(first[i], first[i + 1]))
+                  return first + i + 1;
+
+              return last;
+            }
+
+            /// different_sign, without branches
+            template<typename T>
+            struct SignChange {
+              bool upwards;
+              bool downwards;
+
+              explicit SignChange (int direction) noexcept
+                  : upwards{direction >= 0}, downwards{direction <= 0}
+              {}
+
+              MYUTILITIES_KERNEL bool operator() (T d1, T d2) const noexcept
+              {
+                return (upwards & (d1 < 0) & (d2 >= 0)) | (downwards & (d1 > 0) & (d2 <= 0));
+              }
+            };
+
+            template<typename T>
+            MYUTILITIES_KERNEL const T *find_zero_cross_kernel (const T *first, const T *last, int direction) noexcept
+            {
+              return adjacent_find_blockwise(first, last, SignChange<T>(direction));
+            }
+
+            template<typename T>
+            MYUTILITIES_KERNEL const T *find_zero_cross_kernel (const T *first, const T *last, double max_distance, int direction) noexcept
+            {
+              const SignChange<T> different_sign(direction);
+
+              const auto true_zero_cross = [different_sign, max_distance] (T d1, T d2)
+              {
+                  return different_sign(d1, d2) & (static_cast<double>(std::abs(d1 - d2)) < max_distance);
+              };
+
+              return adjacent_find_blockwise(first, last, true_zero_cross);
+            }
+
+            /// \brief number of adjacent pairs of [first, last) that satisfy a branchless predicate
+            ///
+            /// As in count_inside, the hits of each block of pairs are summed without early exit, so that the sum is vectorized.
+            template<typename T, typename BranchlessPredicate>
+            MYUTILITIES_KERNEL std::size_t count_adjacent_blockwise (const T *first, const T *last, BranchlessPredicate p) noexcept
+            {
+              constexpr std::size_t block_size = 64;
+
+              if (last - first < 2)
+                return 0;
+
+              const auto n_pairs = static_cast<std::size_t>(last - first) - 1;
+              std::size_t i = 0;
+              std::size_t count = 0;
+
+              for (; i + block_size <= n_pairs; i += block_size)
+                {
+                  unsigned block_count = 0;
+                  for (std::size_t k = 0; k < block_size; ++k)
+                    block_count += static_cast<unsigned>(p(first[i + k], first[i + k + 1]));
+                  count += block_count;
+                }
+
+              for (; i < n_pairs; ++i)
+                count += static_cast<std::size_t>(p(first[i], first[i + 1]));
+
+              return count;
+            }
+
+            template<typename T>
+            MYUTILITIES_KERNEL std::size_t count_zero_cross_kernel (const T *first, const T *last, int direction) noexcept
+            {
+              return count_adjacent_blockwise(first, last, SignChange<T>(direction));
+            }
+
+            template<typename T>
+            MYUTILITIES_KERNEL std::size_t count_zero_cross_kernel (const T *first, const T *last, double max_distance, int direction) noexcept
+            {
+              const SignChange<T> different_sign(direction);
+
+              const auto true_zero_cross = [different_sign, max_distance] (T d1, T d2)
+              {
+                  return different_sign(d1, d2) & (static_cast<double>(std::abs(d1 - d2)) < max_distance);
+              };
+
+              return count_adjacent_blockwise(first, last, true_zero_cross);
+            }
+        }
+
+        namespace
+        {
+            /// bit j % 64 of mask[j / 64] is set if first[j - lag] and first[j] cross zero.
+            /// As in is_inside_batch, the tests are made in a separate pass over each block of 64, then packed into bits.
+            template<typename T>
+            MYUTILITIES_KERNEL void zero_cross_mask_kernel (const T *first, const T *last, std::size_t lag,
+                                                            int direction, std::uint64_t *mask) noexcept
+            {
+              constexpr std::size_t block_size = 64;
+
+              const SignChange<T> different_sign(direction);
+              const T *previous = first - lag;
+              const auto size = static_cast<std::size_t>(last - first);
+              std::size_t i = 0;
+
+              for (; i + block_size <= size; i += block_size)
+                {
+                  unsigned char block[block_size];
+                  for (std::size_t k = 0; k < block_size; ++k)
+                    block[k] = different_sign(previous[i + k], first[i + k]);
+
+                  std::uint64_t word = 0;
+                  for (std::size_t k = 0; k < block_size; ++k)
+                    word |= std::uint64_t{block[k]} << k;
+                  *mask++ = word;
+                }
+
+              if (i < size)
+                {
+                  std::uint64_t word = 0;
+                  for (std::size_t k = 0; i + k < size; ++k)
+                    word |= std::uint64_t{different_sign(previous[i + k], first[i + k])} << k;
+                  *mask = word;
+                }
+            }
+        }
+
+        MYUTILITIES_MULTIVERSION
+        void zero_cross_mask (const double *first, const double *last, std::size_t lag, int direction,
+                              std::uint64_t *mask) noexcept
+        {
+          zero_cross_mask_kernel(first, last, lag, direction, mask);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        void zero_cross_mask (const float *first, const float *last, std::size_t lag, int direction,
+                              std::uint64_t *mask) noexcept
+        {
+          zero_cross_mask_kernel(first, last, lag, direction, mask);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        const double *find_zero_cross_contiguous (const double *first, const double *last, int direction) noexcept
+        {
+          return find_zero_cross_kernel(first, last, direction);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        const float *find_zero_cross_contiguous (const float *first, const float *last, int direction) noexcept
+        {
+          return find_zero_cross_kernel(first, last, direction);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        const double *find_zero_cross_contiguous (const double *first, const double *last,
+                                                  double max_distance, int direction) noexcept
+        {
+          return find_zero_cross_kernel(first, last, max_distance, direction);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        const float *find_zero_cross_contiguous (const float *first, const float *last,
+                                                 double max_distance, int direction) noexcept
+        {
+          return find_zero_cross_kernel(first, last, max_distance, direction);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        std::size_t count_zero_cross_contiguous (const double *first, const double *last, int direction) noexcept
+        {
+          return count_zero_cross_kernel(first, last, direction);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        std::size_t count_zero_cross_contiguous (const float *first, const float *last, int direction) noexcept
+        {
+          return count_zero_cross_kernel(first, last, direction);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        std::size_t count_zero_cross_contiguous (const double *first, const double *last,
+                                                 double max_distance, int direction) noexcept
+        {
+          return count_zero_cross_kernel(first, last, max_distance, direction);
+        }
+
+        MYUTILITIES_MULTIVERSION
+        std::size_t count_zero_cross_contiguous (const float *first, const float *last,
+                                                 double max_distance, int direction) noexcept
+        {
+          return count_zero_cross_kernel(first, last, max_distance, direction);
+        }
+    }
+}
@@ -2,6 +2,17 @@
 #include "myUtilities.hpp"
 #include <boost/math/constants/constants.hpp>
 #include <boost/range/algorithm.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <list>
+#include <random>
+#include <sstream>
 
 using namespace testing;
 using namespace PanosUtilities;
@@ -9,6 +20,22 @@ using boost::math::double_constants::two_pi;
 using boost::math::double_constants::pi;
 using boost::math::double_constants::sixth_pi;
 
+template<typename T>
+std::vector<T> random_signal (size_t size, unsigned seed)
+{
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<T> distribution(-1, 1);
+  std::vector<T> signal(size);
+  for (auto& x : signal)
+    x = distribution(generator);
+  //long stretches without crossings and some exact zeros
+  for (size_t i = 0; i < size / 2; ++i)
+    signal[i] = std::abs(signal[i]);
+  for (size_t i = 0; i < size; i += 37)
+    signal[i] = 0;
+  return signal;
+}
+
 TEST(alinspace, throwsWhenInputPointsAreLessThanTwo)
 {
   ASSERT_ANY_THROW(linspace(0, 10, 1));
@@ -29,6 +56,58 @@ TEST(alinspace, returnsCorrectValues)
 
 }
 
+TEST(alinspace_view, GivesSameValuesAsLinspace)
+{
+  const auto eager = linspace(-1.3, 2.7, 1001);
+  const auto lazy = linspace_view(-1.3, 2.7, 1001);
+
+  ASSERT_EQ(lazy.size(), eager.size());
+  ASSERT_TRUE(std::equal(eager.cbegin(), eager.cend(), lazy.begin(), lazy.end()));
+  ASSERT_EQ(lazy[500], eager[500]);
+  ASSERT_EQ(lazy.back(), eager.back());
+}
+
+TEST(alinspace_view, IsConstexprAndRandomAccess)
+{
+  constexpr auto view = linspace_view(0, 1, 11);
+  static_assert(view.size() == 11, "");
+  static_assert(view.front() == 0, "");
+  static_assert(view.back() == 1, "");
+  static_assert(*(view.end() - 6) == 0.5, "");
+
+  ASSERT_EQ(std::distance(view.begin(), view.end()), 11);
+  ASSERT_DOUBLE_EQ(view.begin()[3], 0.3);
+  ASSERT_ANY_THROW(linspace_view(0, 10, 1));
+}
+
+TEST(alinspace_view, CanBeUsedWithZeroCross)
+{
+  auto zeros = std::vector<double>{};
+  zero_cross(linspace_view(-1, 1, 10), std::back_inserter(zeros));
+
+  ASSERT_EQ(zeros.size(), 1);
+  ASSERT_DOUBLE_EQ(zeros[0], 1.0 / 9);
+}
+
+TEST(alinspace_into, FillsBufferLikeLinspace)
+{
+  std::vector<double> buffer(1001);
+  linspace_into(-2.5, 7.25, buffer);
+
+  const auto eager = linspace(-2.5, 7.25, buffer.size());
+
+  //the step is computed once, so samples agree up to rounding relative to the range
+  ASSERT_THAT(buffer, Pointwise(DoubleNear(1e-14), eager));
+  ASSERT_EQ(buffer.front(), -2.5);
+  ASSERT_EQ(buffer.back(), 7.25);
+}
+
+TEST(alinspace_into, throwsWhenBufferHoldsLessThanTwoElements)
+{
+  std::array<double, 1> buffer{};
+  ASSERT_THROW(linspace_into(0, 1, buffer), std::domain_error);
+}
+
 TEST(anInterval, Works)
 {
   auto my_interval = Interval(0, -3.4);
@@ -40,6 +119,125 @@ TEST(anInterval, Works)
   ASSERT_DOUBLE_EQ(my_interval.max(), 0);
 }
 
+TEST(anInterval, IsConstexpr)
+{
+  constexpr Interval my_interval(1, -1);
+  static_assert(my_interval.min() == -1 && my_interval.max() == 1);
+  static_assert(is_inside(0.5, my_interval) && !is_inside(2.0, my_interval));
+  static_assert(clamp(2.0, my_interval) == 1 && clamp(-2.0, my_interval) == -1 && clamp(0.5, my_interval) == 0.5);
+}
+
+TEST(interval_batch_behaviour, AgreesWithScalarVersions)
+{
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<double> distribution(-2, 2);
+  std::vector<double> points(1001);
+  for (auto& x : points)
+    x = distribution(generator);
+  points[0] = -1;
+  points[1] = 1;
+  points[2] = std::numeric_limits<double>::quiet_NaN();
+
+  const Interval my_interval(-1, 1);
+
+  const auto mask = is_inside_batch(my_interval, points);
+  ASSERT_EQ(mask.size(), 16u);
+  std::size_t expected_count = 0;
+  for (std::size_t i = 0; i < points.size(); ++i)
+    {
+      ASSERT_EQ((mask[i / 64] >> (i % 64)) & 1u, is_inside(points[i], my_interval)) << "at " << i;
+      expected_count += is_inside(points[i], my_interval);
+    }
+  ASSERT_EQ(mask.back() >> (points.size() % 64), 0u);
+  ASSERT_EQ(count_inside(my_interval, points), expected_count);
+
+  std::vector<double> clamped(points.size());
+  clamp_batch(my_interval, points.data(), points.data() + points.size(), clamped.data());
+  for (std::size_t i = 3; i < points.size(); ++i)
+    ASSERT_EQ(clamped[i], clamp(points[i], my_interval)) << "at " << i;
+  ASSERT_TRUE(std::isnan(clamped[2]));
+}
+
+TEST(interval_batch_behaviour, PartitionPutsPointsInsideFirst)
+{
+  std::mt19937 generator(13);
+  std::uniform_real_distribution<float> distribution(-2, 2);
+  std::vector<float> points(1000);
+  for (auto& x : points)
+    x = distribution(generator);
+
+  const BasicInterval<float> my_interval(-1, 1);
+  const auto original = points;
+
+  const auto n_inside = partition_inside(my_interval, points);
+
+  ASSERT_EQ(n_inside, count_inside(my_interval, original));
+  for (std::size_t i = 0; i < points.size(); ++i)
+    ASSERT_EQ(is_inside(points[i], my_interval), i < n_inside) << "at " << i;
+  ASSERT_TRUE(std::is_permutation(points.begin(), points.end(), original.begin()));
+}
+
+TEST(anIntervalSet, MergesOverlappingAndTouchingIntervals)
+{
+  const IntervalSet set({Interval(5, 6), Interval(0, 1), Interval(2, 1), Interval(0.5, 0.7), Interval(3, 4)});
+
+  ASSERT_EQ(set.size(), 3u);
+  ASSERT_EQ(set[0].min(), 0);
+  ASSERT_EQ(set[0].max(), 2);
+  ASSERT_EQ(set[1].min(), 3);
+  ASSERT_EQ(set[2].max(), 6);
+
+  ASSERT_TRUE(is_inside(1.5, set));
+  ASSERT_TRUE(is_inside(6.0, set));
+  ASSERT_FALSE(is_inside(2.5, set));
+  ASSERT_FALSE(is_inside(-0.1, set));
+  ASSERT_FALSE(is_inside(7.0, set));
+  ASSERT_EQ(set.find(3.5), 1u);
+  ASSERT_EQ(set.find(4.5), set.size());
+
+  ASSERT_FALSE(is_inside(0.0, IntervalSet{}));
+}
+
+TEST(anIntervalSet, BatchQueriesAgreeWithIsInsideOfEachInterval)
+{
+  std::mt19937 generator(17);
+  std::uniform_real_distribution<double> distribution(0, 100);
+
+  std::vector<Interval> intervals;
+  for (int i = 0; i < 200; ++i)
+    {
+      const double min = distribution(generator);
+      intervals.emplace_back(min, min + distribution(generator) / 100);
+    }
+  const IntervalSet set(intervals.begin(), intervals.end());
+
+  std::vector<double> points(1000);
+  for (auto& x : points)
+    x = distribution(generator);
+  points[0] = intervals[0].min();
+  points[1] = intervals[0].max();
+
+  const auto mask = is_inside_batch(set, points);
+
+  auto sorted_points = points;
+  std::sort(sorted_points.begin(), sorted_points.end());
+  std::vector<std::uint64_t> sorted_mask(is_inside_mask_size(points.size()));
+  set.contains_sorted_batch(sorted_points.data(), sorted_points.data() + sorted_points.size(), sorted_mask.data());
+
+  const auto in_any = [&] (double x)
+  {
+    return std::any_of(intervals.begin(), intervals.end(), [=] (const Interval& interval)
+    { return is_inside(x, interval); });
+  };
+
+  for (std::size_t i = 0; i < points.size(); ++i)
+    {
+      ASSERT_EQ((mask[i / 64] >> (i % 64)) & 1u, in_any(points[i])) << "at " << i;
+      ASSERT_EQ((sorted_mask[i / 64] >> (i % 64)) & 1u, in_any(sorted_points[i])) << "at " << i;
+      ASSERT_EQ(set.contains(points[i]), in_any(points[i])) << "at " << i;
+    }
+}
+
 TEST(uniform_sample_utilities, ExcludeMinWorks)
 {
   const auto my_interval = Interval(0, 3.14);
@@ -55,6 +253,15 @@ TEST(uniform_sample_utilities, ExcludeMinWorks)
 
 }
 
+TEST(uniform_sample_utilities, ViewGivesSameValuesAsUniformSamples)
+{
+  const auto my_interval = Interval(3.14, -1);
+  const auto eager = uniform_samples(my_interval, 57);
+  const auto lazy = uniform_samples_view(my_interval, 57);
+
+  ASSERT_TRUE(std::equal(eager.cbegin(), eager.cend(), lazy.begin(), lazy.end()));
+}
+
 TEST(uniform_sample_utilities, ExcludeMaxWorks)
 {
   const auto my_interval = Interval(0, 3.14);
@@ -71,6 +278,102 @@ TEST(uniform_sample_utilities, ExcludeMaxWorks)
 
 }
 
+TEST(uniform_sample_utilities, IntoVariantsFillBufferLikeEagerVersions)
+{
+  const auto my_interval = Interval(-1, 3.14);
+  std::vector<double> buffer(37);
+
+  uniform_samples_into(my_interval, buffer);
+  ASSERT_THAT(buffer, Pointwise(DoubleNear(1e-14), uniform_samples(my_interval, buffer.size())));
+
+  uniform_samples_exclude_min_into(my_interval, buffer);
+  ASSERT_THAT(buffer, Pointwise(DoubleNear(1e-14), uniform_samples_exclude_min(my_interval, buffer.size())));
+  ASSERT_EQ(buffer.back(), 3.14);
+
+  uniform_samples_exclude_max_into(my_interval, buffer);
+  ASSERT_THAT(buffer, Pointwise(DoubleNear(1e-14), uniform_samples_exclude_max(my_interval, buffer.size())));
+  ASSERT_EQ(buffer.front(), -1);
+}
+
+TEST(uniform_sample_utilities, IntoVariantsRejectSizesRejectedByEagerVersions)
+{
+  const auto my_interval = Interval(-1, 3.14);
+
+  for (std::size_t size : {0u, 1u})
+    {
+      std::vector<double> buffer(size);
+      ASSERT_THROW(uniform_samples_exclude_min(my_interval, size), std::domain_error);
+      ASSERT_THROW(uniform_samples_exclude_min_into(my_interval, buffer), std::domain_error);
+      ASSERT_THROW(uniform_samples_exclude_max(my_interval, size), std::domain_error);
+      ASSERT_THROW(uniform_samples_exclude_max_into(my_interval, buffer), std::domain_error);
+      ASSERT_THROW(uniform_samples_into(my_interval, buffer), std::domain_error);
+    }
+}
+
+TEST(agrid, MatchesNestedUniformSamples)
+{
+  const Grid<3> grid({Interval(0, 1), Interval(-2, 2), Interval(3.14, 6)}, {3, 5, 4});
+
+  ASSERT_EQ(grid.size(), 60);
+
+  const auto x = uniform_samples(Interval(0, 1), 3);
+  const auto y = uniform_samples(Interval(-2, 2), 5);
+  const auto z = uniform_samples(Interval(3.14, 6), 4);
+
+  std::size_t index = 0;
+  for (auto xi : x)
+    for (auto yi : y)
+      for (auto zi : z)
+        {
+          const auto p = grid[index];
+          ASSERT_EQ(p[0], xi);
+          ASSERT_EQ(p[1], yi);
+          ASSERT_EQ(p[2], zi);
+          ++index;
+        }
+}
+
+TEST(agrid, SoaAndAosAgreeWithIndexMapping)
+{
+  const Grid<2> grid({Interval(0, 1), Interval(-1, 1)}, {7, 11});
+
+  const auto soa = grid.soa();
+  const auto aos = grid.aos();
+
+  ASSERT_EQ(aos.size(), grid.size());
+  for (std::size_t i = 0; i < grid.size(); ++i)
+    {
+      ASSERT_EQ(aos[i], grid[i]);
+      ASSERT_EQ(soa[0][i], grid[i][0]);
+      ASSERT_EQ(soa[1][i], grid[i][1]);
+    }
+}
+
+TEST(agrid, ChunksCanBeMaterializedInParallel)
+{
+  const Grid<2> grid({Interval(0, 1), Interval(-1, 1)}, {101, 37});
+
+  const auto chunks = grid.chunks(4);
+  ASSERT_EQ(chunks.size(), 4);
+  ASSERT_EQ(chunks.front().first, 0);
+  ASSERT_EQ(chunks.back().second, grid.size());
+
+  std::vector<Grid<2>::Point> points(grid.size());
+  std::vector<std::future<void>> tasks;
+  for (const auto& chunk : chunks)
+    tasks.push_back(std::async(std::launch::async, [&, chunk]
+    { grid.aos_into(chunk.first, chunk.second, points.data() + chunk.first); }));
+  for (auto& task : tasks)
+    task.get();
+
+  ASSERT_EQ(points, grid.aos());
+}
+
+TEST(agrid, throwsWhenAnAxisHasLessThanTwoSamples)
+{
+  ASSERT_THROW(Grid<2>({Interval(0, 1), Interval(0, 1)}, {3, 1}), std::domain_error);
+}
+
 TEST(wrap_2pi_behaviour, LeavesAngleBetween0and2piUnchanged)
 {
   const double small_angle = 1.2323256;
@@ -159,6 +462,225 @@ TEST(wrap_minus_pi_pi_behaviour, MapsCorrectlyNegativeAngles)
   ASSERT_THAT(wrap_minus_pi_pi(angle2), DoubleNear(small_negative_angle, 1e-13));
 }
 
+TEST(wrap_batch_behaviour, AgreesWithScalarVersions)
+{
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> distribution(-1e3, 1e3);
+  std::vector<double> angles(1001);
+  for (auto& angle : angles)
+    angle = distribution(generator);
+  angles[0] = 0;
+  angles[1] = two_pi;
+  angles[2] = -pi;
+
+  std::vector<double> wrapped(angles.size());
+  wrap_2pi_batch(angles.data(), angles.data() + angles.size(), wrapped.data());
+  for (std::size_t i = 0; i < angles.size(); ++i)
+    ASSERT_THAT(wrapped[i], DoubleNear(wrap_2pi(angles[i]), 1e-13)) << "at " << i;
+
+  wrap_minus_pi_pi_batch(angles.data(), angles.data() + angles.size(), wrapped.data());
+  for (std::size_t i = 0; i < angles.size(); ++i)
+    ASSERT_THAT(wrapped[i], DoubleNear(wrap_minus_pi_pi(angles[i]), 1e-13)) << "at " << i;
+}
+
+TEST(wrap_batch_behaviour, WorksInPlace)
+{
+  std::vector<double> angles{-sixth_pi - 31 * pi, -sixth_pi - 30 * pi, two_pi, 0.5};
+  wrap_minus_pi_pi_inplace(angles);
+
+  ASSERT_THAT(angles, Pointwise(DoubleNear(1e-13), {pi - sixth_pi, -sixth_pi, 0., 0.5}));
+
+  wrap_2pi_inplace(angles);
+  ASSERT_THAT(angles, Pointwise(DoubleNear(1e-13), {pi - sixth_pi, two_pi - sixth_pi, 0., 0.5}));
+}
+
+template<typename T>
+class floating_point_utilities_behaviour : public ::testing::Test {
+ protected:
+  //tolerance relative to the magnitude of the values involved
+  static constexpr long double tolerance = 8 * std::numeric_limits<T>::epsilon();
+};
+
+using AllFloatingPointTypes = ::testing::Types<float, double, long double>;
+TYPED_TEST_SUITE(floating_point_utilities_behaviour, AllFloatingPointTypes);
+
+TYPED_TEST(floating_point_utilities_behaviour, LinspaceIsAccurate)
+{
+  using T = TypeParam;
+  const auto samples = basic_linspace<T>(-1.5, 2.5, 101);
+
+  ASSERT_EQ(samples.size(), 101);
+  ASSERT_EQ(samples.front(), T(-1.5));
+  ASSERT_EQ(samples.back(), T(2.5));
+
+  std::vector<T> buffer(101);
+  linspace_into(-1.5, 2.5, buffer);
+
+  for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+      const long double exact = -1.5L + 4.0L * i / 100;
+      ASSERT_LE(std::abs(samples[i] - exact), 2.5 * this->tolerance) << "at " << i;
+      ASSERT_LE(std::abs(buffer[i] - exact), 2.5 * this->tolerance) << "at " << i;
+    }
+}
+
+TYPED_TEST(floating_point_utilities_behaviour, IntervalSamplesHaveTheIntervalType)
+{
+  using T = TypeParam;
+  const BasicInterval<T> interval(3, -1);
+
+  ASSERT_EQ(interval.min(), T(-1));
+  ASSERT_TRUE(is_inside(0.5, interval));
+  ASSERT_FALSE(is_inside(3.5, interval));
+
+  const std::vector<T> samples = uniform_samples(interval, 9);
+  const auto view = uniform_samples_view(interval, 9);
+  ASSERT_TRUE(std::equal(samples.cbegin(), samples.cend(), view.begin(), view.end()));
+
+  const std::vector<T> no_min = uniform_samples_exclude_min(interval, 8);
+  ASSERT_TRUE(std::equal(no_min.cbegin(), no_min.cend(), samples.cbegin() + 1,
+                         [this] (T a, T b) { return std::abs(a - b) <= 4 * this->tolerance; }));
+}
+
+TYPED_TEST(floating_point_utilities_behaviour, WrapIsAccurate)
+{
+  using T = TypeParam;
+  const long double two_pi_l = boost::math::constants::two_pi<long double>();
+
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<long double> distribution(-100, 100);
+  for (int i = 0; i < 1000; ++i)
+    {
+      const T angle = static_cast<T>(distribution(generator));
+      const long double exact = angle - two_pi_l * std::floor(angle / two_pi_l);
+      const long double magnitude = std::max<long double>(std::abs(angle), 1);
+
+      const long double exact_minus_pi_pi = exact >= two_pi_l / 2 ? exact - two_pi_l : exact;
+
+      //compared in long double, as ASSERT_NEAR would round to double
+      ASSERT_LE(std::abs(basic_wrap_2pi(angle) - exact), this->tolerance * magnitude) << angle;
+      ASSERT_LE(std::abs(basic_wrap_minus_pi_pi(angle) - exact_minus_pi_pi), this->tolerance * magnitude) << angle;
+    }
+}
+
+TEST(wrap_batch_behaviour, FloatBatchAgreesWithScalarVersion)
+{
+  const auto angles = random_signal<float>(1001, 5);
+  std::vector<float> wrapped(angles.size());
+  std::vector<float> scaled(angles.size());
+  std::transform(angles.cbegin(), angles.cend(), scaled.begin(), [] (float x) { return 50 * x; });
+
+  wrap_2pi_batch(scaled.data(), scaled.data() + scaled.size(), wrapped.data());
+  for (std::size_t i = 0; i < scaled.size(); ++i)
+    ASSERT_NEAR(wrapped[i], basic_wrap_2pi(scaled[i]), 1e-5f) << "at " << i;
+
+  wrap_minus_pi_pi_inplace(scaled);
+  for (std::size_t i = 0; i < scaled.size(); ++i)
+    ASSERT_NEAR(scaled[i], basic_wrap_minus_pi_pi(50 * angles[i]), 1e-5f) << "at " << i;
+}
+
+TEST(wrap_near_behaviour, AgreesWithWrapWithinItsErrorBound)
+{
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<double> distribution(-two_pi, 2 * two_pi);
+  const double bound = 2 * two_pi * std::numeric_limits<double>::epsilon();
+
+  for (int i = 0; i < 1000; ++i)
+    {
+      const double angle = distribution(generator);
+      ASSERT_NEAR(wrap_2pi_near(angle), wrap_2pi(angle), bound) << angle;
+      ASSERT_NEAR(wrap_minus_pi_pi_near(angle - pi), wrap_minus_pi_pi(angle - pi), bound) << angle;
+    }
+
+  ASSERT_NEAR(wrap_2pi_near<3>(sixth_pi - 3 * two_pi), sixth_pi, 12 * two_pi * 1e-16);
+  ASSERT_NEAR(wrap_minus_pi_pi_near<3>(-sixth_pi + 3 * two_pi), -sixth_pi, 12 * two_pi * 1e-16);
+}
+
+TEST(wrap_near_behaviour, BatchAgreesWithScalarVersions)
+{
+  std::mt19937 generator(13);
+  std::uniform_real_distribution<double> distribution(-2 * two_pi, 3 * two_pi);
+  std::vector<double> angles(1001);
+  for (auto& angle : angles)
+    angle = distribution(generator);
+
+  std::vector<double> wrapped(angles.size());
+  wrap_2pi_near_batch(angles.data(), angles.data() + angles.size(), wrapped.data(), 2);
+  for (std::size_t i = 0; i < angles.size(); ++i)
+    ASSERT_EQ(wrapped[i], wrap_2pi_near<2>(angles[i])) << "at " << i;
+
+  wrap_minus_pi_pi_near_batch(angles.data(), angles.data() + angles.size(), wrapped.data(), 2);
+  for (std::size_t i = 0; i < angles.size(); ++i)
+    ASSERT_EQ(wrapped[i], wrap_minus_pi_pi_near<2>(angles[i])) << "at " << i;
+
+  const std::vector<float> float_angles(angles.cbegin(), angles.cend());
+  std::vector<float> float_wrapped(angles.size());
+  wrap_2pi_near_batch(float_angles.data(), float_angles.data() + float_angles.size(), float_wrapped.data(), 2);
+  for (std::size_t i = 0; i < angles.size(); ++i)
+    ASSERT_EQ(float_wrapped[i], basic_wrap_2pi_near<2>(float_angles[i])) << "at " << i;
+}
+
+TEST(unwrap_behaviour, RecoversContinuousPhase)
+{
+  const auto phase = linspace(-20, 50, 1000);
+  std::list<double> wrapped;
+  for (auto x : phase)
+    wrapped.push_back(wrap_minus_pi_pi(x));
+
+  std::vector<double> unwrapped;
+  unwrap(wrapped.cbegin(), wrapped.cend(), std::back_inserter(unwrapped));
+
+  //the phase, shifted by the multiple of 2*pi removed from its first sample
+  const double shift = wrapped.front() - phase.front();
+  ASSERT_EQ(unwrapped.size(), phase.size());
+  for (std::size_t i = 0; i < phase.size(); ++i)
+    ASSERT_NEAR(unwrapped[i], phase[i] + shift, 1e-12) << "at " << i;
+}
+
+TEST(unwrap_behaviour, LeavesJumpsUpToPiUnchanged)
+{
+  const std::vector<double> angles{0, 3, -0.1, 3.0, 0.5};
+  std::vector<double> unwrapped(angles.size());
+  unwrap(angles.cbegin(), angles.cend(), unwrapped.begin());
+
+  ASSERT_THAT(unwrapped, ElementsAreArray(angles));
+}
+
+TEST(unwrap_behaviour, BatchAndParallelAgreeWithSequential)
+{
+  std::mt19937 generator(17);
+  std::uniform_real_distribution<double> step(-0.5, 1.5);
+  std::vector<double> angles(1 << 17);
+  double phase = 0;
+  for (auto& angle : angles)
+    {
+      phase += step(generator);
+      angle = wrap_minus_pi_pi(phase);
+    }
+
+  std::vector<double> sequential(angles.size());
+  unwrap(angles.cbegin(), angles.cend(), sequential.begin());
+
+  std::vector<double> batch(angles.size());
+  unwrap_batch(angles.data(), angles.data() + angles.size(), batch.data());
+  ASSERT_THAT(batch, Pointwise(DoubleNear(1e-9), sequential));
+
+  std::vector<double> parallel(angles.size());
+  unwrap_parallel(angles.data(), angles.data() + angles.size(), parallel.data(), 4);
+  ASSERT_EQ(parallel, batch);
+
+  auto in_place = angles;
+  unwrap_parallel(in_place.data(), in_place.data() + in_place.size(), in_place.data(), 4);
+  ASSERT_EQ(in_place, batch);
+
+  const std::vector<float> float_angles(angles.cbegin(), angles.cend());
+  std::vector<float> float_sequential(angles.size());
+  unwrap(float_angles.cbegin(), float_angles.cend(), float_sequential.begin());
+  auto float_batch = float_angles;
+  unwrap_inplace(float_batch);
+  ASSERT_THAT(float_batch, Pointwise(FloatNear(1e-2f), float_sequential));
+}
+
 TEST(zero_cross_behaviour, FindsSecondOfTwoElementsWhenChangeOfSign)
 {
   auto values = std::vector<double>{-1, 1};
@@ -431,6 +953,378 @@ TEST(zero_cross_transformed_behaviour, DiscardsCrossingsWhenDifferenceGreaterTha
   ASSERT_TRUE(are_equal);
 }
 
+TEST(zero_cross_transformed_behaviour, TransformsEachElementOnce)
+{
+  const auto values = std::vector<double>{-2, -1, 1, -3, -2, 1, 4, -1};
+  int n_calls = 0;
+  const auto counting_identity = [&n_calls] (double x)
+  {
+      ++n_calls;
+      return x;
+  };
+
+  auto zeros = std::vector<double>{};
+  zero_cross_transformed(values.cbegin(), values.cend(), std::back_inserter(zeros), counting_identity);
+  ASSERT_EQ(zeros, (std::vector<double>{1, -3, 1, -1}));
+  ASSERT_EQ(n_calls, values.size());
+
+  n_calls = 0;
+  zeros.clear();
+  zero_cross_transformed(values.cbegin(), values.cend(), std::back_inserter(zeros), counting_identity, 4.5);
+  ASSERT_EQ(zeros, (std::vector<double>{1, -3, 1}));
+  ASSERT_EQ(n_calls, values.size());
+
+  n_calls = 0;
+  ASSERT_EQ(find_zero_cross_transformed(values.cbegin(), values.cend(), counting_identity, -1), values.cbegin() + 3);
+  ASSERT_EQ(n_calls, 4);
+}
+
+/// a signal that counts how many times it is copied or moved
+struct CopyCountingSignal {
+  std::vector<double> values;
+  int* copies;
+
+  CopyCountingSignal (std::vector<double> v, int* n_copies)
+      : values(std::move(v)), copies(n_copies)
+  {}
+
+  CopyCountingSignal (const CopyCountingSignal& other)
+      : values(other.values), copies(other.copies)
+  { ++*copies; }
+
+  CopyCountingSignal (CopyCountingSignal&& other) noexcept
+      : values(std::move(other.values)), copies(other.copies)
+  { ++*copies; }
+
+  auto begin () const
+  { return values.begin(); }
+
+  auto end () const
+  { return values.end(); }
+};
+
+/// a range that, like some C++20 views, can only be iterated when it is not const
+struct MutableOnlySignal {
+  std::vector<double> values;
+
+  auto begin ()
+  { return values.begin(); }
+
+  auto end ()
+  { return values.end(); }
+};
+
+TEST(zero_cross_range_behaviour, NeverCopiesOrMovesTheRange)
+{
+  int n_copies = 0;
+  CopyCountingSignal signal({-2, -1, 1, -3, -2, 1, 4, -1}, &n_copies);
+  const auto& const_signal = signal;
+  const auto identity = [] (double x)
+  { return x; };
+
+  auto zeros = std::vector<double>{};
+  zero_cross(signal, std::back_inserter(zeros));
+  zero_cross(const_signal, std::back_inserter(zeros), 4.5);
+  zero_cross_transformed(signal, std::back_inserter(zeros), identity);
+  zero_cross_transformed(const_signal, std::back_inserter(zeros), identity, 4.5, 1);
+  zero_cross(CopyCountingSignal({1, -1}, &n_copies), std::back_inserter(zeros));
+
+  ASSERT_EQ(zeros, (std::vector<double>{1, -3, 1, -1, 1, -3, 1, 1, -3, 1, -1, 1, 1, -1}));
+  ASSERT_EQ(n_copies, 0);
+}
+
+TEST(zero_cross_range_behaviour, AcceptsRangesIterableOnlyWhenNotConst)
+{
+  MutableOnlySignal signal{{-2, -1, 1, -3, -2, 1, 4, -1}};
+
+  auto zeros = std::vector<double>{};
+  zero_cross(signal, std::back_inserter(zeros), -1);
+  ASSERT_EQ(zeros, (std::vector<double>{-3, -1}));
+
+  zeros.clear();
+  zero_cross_transformed(MutableOnlySignal{{2, -1}}, std::back_inserter(zeros), [] (double x)
+  { return x; });
+  ASSERT_EQ(zeros, (std::vector<double>{-1}));
+}
+
+TEST(zero_cross_transformed_behaviour, ReturnsTransformedValuesOfCrossingPair)
+{
+  using State = std::array<double, 2>;
+
+  const auto values = std::vector<State>{{-2, 1},
+                                         {-1, -1},
+                                         {1,  -1},
+                                         {-3, -2}};
+
+  const auto pick_first = [] (State s)
+  { return s[0]; };
+
+  const auto crossing = find_zero_cross_transformed_values(values.cbegin(), values.cend(), pick_first, -1);
+  ASSERT_EQ(crossing.position, values.cbegin() + 3);
+  ASSERT_DOUBLE_EQ(crossing.previous_value, 1);
+  ASSERT_DOUBLE_EQ(crossing.value, -3);
+
+  const auto filtered_crossing = find_zero_cross_transformed_values(values.cbegin(), values.cend(), pick_first, 3.0);
+  ASSERT_EQ(filtered_crossing.position, values.cbegin() + 2);
+  ASSERT_DOUBLE_EQ(filtered_crossing.previous_value, -1);
+  ASSERT_DOUBLE_EQ(filtered_crossing.value, 1);
+
+  const auto no_crossing = find_zero_cross_transformed_values(values.cbegin(), values.cbegin() + 2, pick_first);
+  ASSERT_EQ(no_crossing.position, values.cbegin() + 2);
+}
+
+TEST(zero_cross_detector_behaviour, ReportsSameCrossingsAsZeroCrossOneSampleAtATime)
+{
+  const auto signal = random_signal<double>(1000, 3);
+
+  for (int direction : {-1, 0, 1})
+    {
+      std::vector<double> expected_zeros, zeros, expected_filtered_zeros, filtered_zeros;
+      zero_cross(signal.cbegin(), signal.cend(), std::back_inserter(expected_zeros), direction);
+      zero_cross(signal.cbegin(), signal.cend(), std::back_inserter(expected_filtered_zeros), 0.5, direction);
+
+      ZeroCrossDetector<double> detector(direction);
+      ZeroCrossDetector<double> filtering_detector(0.5, direction);
+      for (const auto x : signal)
+        {
+          if (detector.push(x))
+            zeros.push_back(x);
+          if (filtering_detector.push(x))
+            filtered_zeros.push_back(x);
+        }
+
+      ASSERT_EQ(zeros, expected_zeros);
+      ASSERT_EQ(filtered_zeros, expected_filtered_zeros);
+      ASSERT_EQ(detector.samples(), signal.size());
+    }
+}
+
+TEST(zero_cross_detector_behaviour, ReportsIndicesOfCrossingsAcrossBlocks)
+{
+  const auto signal = std::vector<double>{-2, -1, 1, -3, -2, 1, 2, -1};
+  const auto expected_indices = std::vector<size_t>{2, 3, 5, 7};
+
+  //block boundaries fall right on crossings
+  ZeroCrossDetector<double> detector;
+  auto indices = std::vector<size_t>{};
+  auto out = std::back_inserter(indices);
+  out = detector.push(signal.cbegin(), signal.cbegin() + 2, out);
+  out = detector.push(signal.cbegin() + 2, signal.cbegin() + 3, out);
+  out = detector.push(std::vector<double>(signal.cbegin() + 3, signal.cbegin() + 7), out);
+  out = detector.push(signal.cbegin() + 7, signal.cend(), out);
+  ASSERT_EQ(indices, expected_indices);
+
+  detector.reset();
+  indices.clear();
+  detector.push(signal, std::back_inserter(indices));
+  ASSERT_EQ(indices, expected_indices);
+  ASSERT_EQ(detector.samples(), signal.size());
+}
+
+template<typename T>
+class zero_cross_channels_behaviour : public ::testing::Test {
+ protected:
+  static constexpr std::size_t n_channels = 5;
+  static constexpr std::size_t length = 3001;
+
+  std::vector<std::vector<T>> channels;
+  std::vector<const T *> pointers;
+
+  zero_cross_channels_behaviour ()
+  {
+    for (std::size_t c = 0; c < n_channels; ++c)
+      {
+        channels.push_back(random_signal<T>(length, static_cast<unsigned>(c)));
+        pointers.push_back(channels.back().data());
+      }
+  }
+
+  /// the crossings of each channel found by ZeroCrossDetector, ordered by index and then by channel
+  std::vector<ChannelCrossing> expected_crossings (int direction) const
+  {
+    std::vector<ChannelCrossing> expected;
+    for (std::size_t c = 0; c < n_channels; ++c)
+      {
+        std::vector<std::size_t> indices;
+        ZeroCrossDetector<T>(direction).push(channels[c], std::back_inserter(indices));
+        for (auto index : indices)
+          expected.push_back({c, index});
+      }
+    std::sort(expected.begin(), expected.end(), [] (const ChannelCrossing& a, const ChannelCrossing& b)
+    { return std::make_pair(a.index, a.channel) < std::make_pair(b.index, b.channel); });
+    return expected;
+  }
+};
+
+using ContiguousKernelTypes = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(zero_cross_channels_behaviour, ContiguousKernelTypes);
+
+TYPED_TEST(zero_cross_channels_behaviour, StructureOfArraysAgreesWithDetectorOfEachChannel)
+{
+  for (int direction : {-1, 0, 1})
+    {
+      std::vector<ChannelCrossing> crossings;
+      zero_cross_channels(this->pointers.data(), this->n_channels, this->length, std::back_inserter(crossings),
+                          direction);
+      ASSERT_EQ(crossings, this->expected_crossings(direction)) << "direction " << direction;
+    }
+}
+
+TYPED_TEST(zero_cross_channels_behaviour, InterleavedAgreesWithStructureOfArrays)
+{
+  std::vector<TypeParam> interleaved(this->n_channels * this->length);
+  for (std::size_t i = 0; i < this->length; ++i)
+    for (std::size_t c = 0; c < this->n_channels; ++c)
+      interleaved[i * this->n_channels + c] = this->channels[c][i];
+
+  for (int direction : {-1, 0, 1})
+    {
+      std::vector<ChannelCrossing> crossings;
+      zero_cross_interleaved(interleaved.data(), this->n_channels, this->length, std::back_inserter(crossings),
+                             direction);
+      ASSERT_EQ(crossings, this->expected_crossings(direction)) << "direction " << direction;
+    }
+}
+
+TYPED_TEST(zero_cross_channels_behaviour, PerChannelOutputsAgreeWithDetector)
+{
+  std::vector<std::vector<std::size_t>> indices(this->n_channels);
+  std::vector<std::back_insert_iterator<std::vector<std::size_t>>> outs;
+  for (auto& channel_indices : indices)
+    outs.push_back(std::back_inserter(channel_indices));
+
+  zero_cross_per_channel(this->pointers.data(), this->n_channels, this->length, outs.data());
+
+  for (std::size_t c = 0; c < this->n_channels; ++c)
+    {
+      std::vector<std::size_t> expected;
+      ZeroCrossDetector<TypeParam>().push(this->channels[c], std::back_inserter(expected));
+      ASSERT_EQ(indices[c], expected) << "channel " << c;
+    }
+}
+
+TEST(zero_cross_interpolated_behaviour, FindsFractionalIndexLinearly)
+{
+  const auto values = std::vector<int>{-2, -1, 3, 2, 0, -1, 1};
+  auto zeros = std::vector<double>{};
+
+  zero_cross_interpolated(values.cbegin(), values.cend(), std::back_inserter(zeros));
+  ASSERT_EQ(zeros.size(), 3);
+  ASSERT_DOUBLE_EQ(zeros[0], 1.25);
+  ASSERT_DOUBLE_EQ(zeros[1], 4);
+  ASSERT_DOUBLE_EQ(zeros[2], 5.5);
+
+  zeros.clear();
+  zero_cross_interpolated(values.cbegin(), values.cend(), std::back_inserter(zeros), 2.5, 1);
+  ASSERT_EQ(zeros, (std::vector<double>{5.5}));
+}
+
+TEST(zero_cross_interpolated_behaviour, CubicInterpolationIsMoreAccurateThanLinear)
+{
+  const auto x = linspace(0, 11, 44);
+  auto values = std::vector<double>{};
+  for (const auto xi : x)
+    values.push_back(std::sin(xi) + 0.5);
+
+  const auto exact_zeros = std::vector<double>{7 * sixth_pi, 11 * sixth_pi, 7 * sixth_pi + two_pi};
+
+  auto linear_zeros = std::vector<double>{};
+  auto cubic_zeros = std::vector<double>{};
+  zero_cross_interpolated_abscissa(values.cbegin(), values.cend(), x.cbegin(), std::back_inserter(linear_zeros));
+  zero_cross_interpolated_abscissa(values.cbegin(), values.cend(), x.cbegin(), std::back_inserter(cubic_zeros),
+                                   0, Interpolation::cubic);
+
+  ASSERT_EQ(linear_zeros.size(), exact_zeros.size());
+  ASSERT_EQ(cubic_zeros.size(), exact_zeros.size());
+  for (size_t k = 0; k < exact_zeros.size(); ++k)
+    {
+      ASSERT_THAT(linear_zeros[k], DoubleNear(exact_zeros[k], 1e-2));
+      ASSERT_THAT(cubic_zeros[k], DoubleNear(exact_zeros[k], 1e-3));
+      ASSERT_LT(std::abs(cubic_zeros[k] - exact_zeros[k]), std::abs(linear_zeros[k] - exact_zeros[k]));
+    }
+}
+
+TEST(zero_cross_interpolated_behaviour, CubicInterpolationHandlesCrossingsAtTheEnds)
+{
+  const auto values = std::vector<double>{-1, 1, 2, -2};
+  auto zeros = std::vector<double>{};
+
+  zero_cross_interpolated(values.cbegin(), values.cend(), std::back_inserter(zeros), 0, Interpolation::cubic);
+
+  ASSERT_EQ(zeros.size(), 2);
+  ASSERT_GT(zeros[0], 0);
+  ASSERT_LT(zeros[0], 1);
+  ASSERT_GT(zeros[1], 2);
+  ASSERT_LT(zeros[1], 3);
+}
+
+TEST(zero_cross_roots_behaviour, RefinesRootsToFullPrecision)
+{
+  const auto grid = uniform_samples(Interval(0.5, 10), 20);
+  auto roots = std::vector<double>{};
+
+  zero_cross_roots(grid, std::back_inserter(roots), [] (double x)
+  { return std::sin(x); });
+
+  ASSERT_THAT(roots, Pointwise(DoubleNear(1e-14), {pi, two_pi, 3 * pi}));
+
+  roots.clear();
+  zero_cross_roots(grid.cbegin(), grid.cend(), std::back_inserter(roots), [] (double x)
+  { return std::sin(x); }, 0, 1);
+  ASSERT_THAT(roots, Pointwise(DoubleNear(1e-14), {two_pi}));
+}
+
+TEST(zero_cross_roots_behaviour, StopsAtTheRequestedTolerance)
+{
+  const auto grid = uniform_samples(Interval(0, 3), 4);
+  int n_calls = 0;
+  const auto f = [&n_calls] (double x)
+  {
+      ++n_calls;
+      return std::exp(x) - 2;
+  };
+
+  auto roots = std::vector<double>{};
+  zero_cross_roots(grid, std::back_inserter(roots), f, 1e-3);
+  ASSERT_EQ(roots.size(), 1u);
+  ASSERT_NEAR(roots[0], std::log(2.0), 1e-3);
+  const auto coarse_calls = n_calls;
+
+  n_calls = 0;
+  roots.clear();
+  zero_cross_roots(grid, std::back_inserter(roots), f);
+  ASSERT_NEAR(roots[0], std::log(2.0), 1e-15);
+  ASSERT_LT(coarse_calls, n_calls);
+}
+
+TEST(zero_cross_roots_behaviour, ReturnsGridPointsWhereFunctionIsZero)
+{
+  const auto grid = std::vector<float>{-2, -1, 0, 1, 2};
+  auto roots = std::vector<float>{};
+
+  zero_cross_roots(grid, std::back_inserter(roots), [] (float x)
+  { return x - 1; });
+
+  ASSERT_EQ(roots, (std::vector<float>{1}));
+}
+
+TEST(zero_cross_roots_behaviour, ParallelVersionAgreesWithSequential)
+{
+  const auto grid = uniform_samples(Interval(0, 100), 1001);
+  const auto f = [] (double x)
+  { return std::sin(x) + 0.5 * std::cos(3.1 * x); };
+
+  auto roots = std::vector<double>{};
+  zero_cross_roots(grid, std::back_inserter(roots), f);
+
+  for (unsigned n_threads : {1u, 3u, 16u})
+    {
+      auto parallel_roots = std::vector<double>{};
+      zero_cross_roots_parallel(grid.cbegin(), grid.cend(), std::back_inserter(parallel_roots), n_threads, f);
+      ASSERT_EQ(parallel_roots, roots) << n_threads << " threads";
+    }
+}
+
 TEST(zero_cross_behaviour, SupportsRanges)
 {
   const auto values = std::vector<int>{-2, -1, 1, -30};
@@ -442,6 +1336,453 @@ TEST(zero_cross_behaviour, SupportsRanges)
 
 }
 
+TEST(doubles_from_string_behaviour, ReadsSignedNumbersAndExponents)
+{
+  const auto values = doubles_from_string("1 -2.5 +3. 4e2 -5.5E-1");
+  const auto expected = std::vector<double>{1, -2.5, 3, 400, -0.55};
+
+  ASSERT_EQ(values.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    ASSERT_DOUBLE_EQ(values[i], expected[i]);
+}
+
+TEST(doubles_from_string_behaviour, SkipsCharactersThatAreNotPartOfANumber)
+{
+  //".5" is read as 5, "1e" as 1 and "--2" as -2, as the leading dot, trailing e and extra sign are not part of a number
+  const auto values = doubles_from_string("x=.5, 1e, --2;abc7def");
+  const auto expected = std::vector<double>{5, 1, -2, 7};
+
+  ASSERT_EQ(values.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    ASSERT_DOUBLE_EQ(values[i], expected[i]);
+}
+
+TEST(doubles_from_string_behaviour, AppendsToCallerProvidedBuffer)
+{
+  auto values = std::vector<double>{42};
+
+  const auto n_read = doubles_from_string(std::string("3.5\t-1e-3\n"), values);
+
+  ASSERT_EQ(n_read, 2);
+  ASSERT_EQ(values.size(), 3);
+  ASSERT_DOUBLE_EQ(values[0], 42);
+  ASSERT_DOUBLE_EQ(values[1], 3.5);
+  ASSERT_DOUBLE_EQ(values[2], -1e-3);
+}
+
+TEST(trimm_comments_behaviour, RemovesEverythingAfterTheCommentCharacter)
+{
+  ASSERT_EQ(trimm_comments("1 2 # 3 4"), "1 2 ");
+  ASSERT_EQ(trimm_comments("1 2 ; 3 % 4", ";%"), "1 2 ");
+  ASSERT_EQ(trimm_comments("1 2"), "1 2");
+}
+
+TEST(numeric_table_behaviour, ReadsOneRowPerLineSkippingCommentsAndEmptyLines)
+{
+  const auto table = parse_numeric_table("# header\n1 2 3 # comment 4\n\n4 5 6\n7 8 9");
+
+  ASSERT_EQ(table.rows(), 3);
+  ASSERT_EQ(table.columns(), 3);
+  ASSERT_EQ(table.values(), (std::vector<double>{1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  ASSERT_EQ(table.row_offsets(), (std::vector<size_t>{0, 3, 6, 9}));
+  ASSERT_DOUBLE_EQ(table(1, 2), 6);
+}
+
+TEST(numeric_table_behaviour, SupportsRowsOfDifferentSizesInRowMajorOrder)
+{
+  const auto table = parse_numeric_table("1 2\n3\n4 5 6\n");
+
+  ASSERT_EQ(table.rows(), 3);
+  ASSERT_EQ(table.columns(), 0);
+  ASSERT_EQ(table.row_size(1), 1);
+  ASSERT_DOUBLE_EQ(table(2, 1), 5);
+}
+
+TEST(numeric_table_behaviour, StoresColumnsContiguouslyInColumnMajorOrder)
+{
+  const auto table = parse_numeric_table("1 2 3\n4 5 6\n", StorageOrder::column_major);
+
+  ASSERT_EQ(table.values(), (std::vector<double>{1, 4, 2, 5, 3, 6}));
+  ASSERT_DOUBLE_EQ(table(0, 2), 3);
+  ASSERT_DOUBLE_EQ(table(1, 0), 4);
+}
+
+TEST(numeric_table_behaviour, ThrowsWhenColumnMajorRowsHaveDifferentSizes)
+{
+  ASSERT_THROW(parse_numeric_table("1 2\n3\n", StorageOrder::column_major), std::domain_error);
+}
+
+TEST(numeric_table_behaviour, GivesSameResultForAnyNumberOfThreads)
+{
+  std::string text = "# generated table\n";
+  //long enough to be split in a few dozen chunks
+  for (int i = 0; i < 30000; ++i)
+    text += std::to_string(i) + " " + std::to_string(-0.5 * i) + ((i % 7) ? "\n" : " # comment 1 2 3\n\n");
+  ASSERT_GT(text.size(), 32u << 14);
+
+  const auto sequential = parse_numeric_table(text);
+
+  for (unsigned n_threads : {0u, 2u, 3u, 8u, 5000u})
+    {
+      const auto parallel = parse_numeric_table(text, StorageOrder::row_major, "#", n_threads);
+      ASSERT_EQ(parallel.values(), sequential.values());
+      ASSERT_EQ(parallel.row_offsets(), sequential.row_offsets());
+    }
+}
+
+TEST(numeric_table_behaviour, ReadsFromFile)
+{
+  const std::string path = "numeric_table_behaviour_ReadsFromFile.txt";
+  {
+    std::ofstream file(path);
+    file << "% t x\n0 1.5\n1 -2.5 % last row\n";
+  }
+
+  const auto table = read_numeric_table(path, StorageOrder::row_major, "%");
+  std::remove(path.c_str());
+
+  ASSERT_EQ(table.values(), (std::vector<double>{0, 1.5, 1, -2.5}));
+  ASSERT_EQ(table.columns(), 2);
+}
+
+TEST(numeric_table_cache_behaviour, LoadsFromCacheWhileSourceIsUnchanged)
+{
+  const std::string path = "numeric_table_cache_behaviour_source.txt";
+  const std::string cache_path = "numeric_table_cache_behaviour_source.cache";
+  std::remove(cache_path.c_str());
+
+  std::ofstream(path) << "1 2\n3 4\n";
+
+  const auto parsed = read_numeric_table_cached(path, cache_path);
+  ASSERT_TRUE(std::filesystem::exists(cache_path));
+  ASSERT_EQ(parsed.values(), (std::vector<double>{1, 2, 3, 4}));
+
+  //same size and modification time: the cache is trusted, and the new content is not seen
+  const auto mtime = std::filesystem::last_write_time(path);
+  std::ofstream(path) << "5 6\n7 8\n";
+  std::filesystem::last_write_time(path, mtime);
+
+  const auto cached = read_numeric_table_cached(path, cache_path, StorageOrder::column_major);
+  ASSERT_EQ(cached.values(), (std::vector<double>{1, 3, 2, 4}));
+  ASSERT_EQ(cached.row_offsets(), parsed.row_offsets());
+
+  //a different size invalidates the cache
+  std::ofstream(path) << "5 6\n7 8\n9 10\n";
+  const auto reparsed = read_numeric_table_cached(path, cache_path);
+  ASSERT_EQ(reparsed.values(), (std::vector<double>{5, 6, 7, 8, 9, 10}));
+
+  std::remove(path.c_str());
+  std::remove(cache_path.c_str());
+}
+
+TEST(numeric_table_cache_behaviour, ReparsesWhenCacheIsCorrupt)
+{
+  const std::string path = "numeric_table_cache_behaviour_corrupt.txt";
+  const std::string cache_path = "numeric_table_cache_behaviour_corrupt.cache";
+
+  std::ofstream(path) << "1 2 3\n";
+  std::ofstream(cache_path) << "not a cache";
+
+  const auto table = read_numeric_table_cached(path, cache_path);
+  ASSERT_EQ(table.values(), (std::vector<double>{1, 2, 3}));
+
+  std::remove(path.c_str());
+  std::remove(cache_path.c_str());
+}
+
+TEST(numeric_table_cache_behaviour, ConcurrentWritersLeaveAValidCache)
+{
+  //a directory of its own, so that a failed run leaves nothing in the working directory
+  //and unrelated files are never mistaken for leftovers
+  const auto directory = std::filesystem::temp_directory_path() / "numeric_table_cache_behaviour_concurrent";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directory(directory);
+
+  const std::string path = (directory / "source.txt").string();
+  const std::string cache_path = (directory / "source.cache").string();
+
+  {
+    std::ofstream os(path);
+    for (int i = 0; i < 10000; ++i)
+      os << i << ' ' << -i << '\n';
+  }
+  const auto expected = read_numeric_table(path);
+
+  std::vector<std::future<NumericTable>> readers;
+  for (int i = 0; i < 4; ++i)
+    readers.push_back(std::async(std::launch::async, [&]
+    { return read_numeric_table_cached(path, cache_path); }));
+  for (auto& reader : readers)
+    ASSERT_EQ(reader.get().values(), expected.values());
+
+  ASSERT_EQ(read_numeric_table_cached(path, cache_path).values(), expected.values());
+
+  //the temporary files are named cache_path followed by a unique suffix
+  const auto temporary_prefix = std::filesystem::path(cache_path).filename().string() + ".";
+  for (const auto& entry : std::filesystem::directory_iterator(directory))
+    ASSERT_NE(entry.path().filename().string().rfind(temporary_prefix, 0), 0u) << entry.path();
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(numeric_table_cache_behaviour, ReparsesWhenCacheCannotBeMapped)
+{
+  const std::string path = "numeric_table_cache_behaviour_unmappable.txt";
+  const std::string cache_path = "numeric_table_cache_behaviour_unmappable.cache";
+
+  std::ofstream(path) << "1 2 3\n";
+  std::filesystem::create_directory(cache_path);
+
+  const auto table = read_numeric_table_cached(path, cache_path);
+  ASSERT_EQ(table.values(), (std::vector<double>{1, 2, 3}));
+
+  std::remove(path.c_str());
+  std::filesystem::remove(cache_path);
+}
+
+TEST(numeric_table_cache_behaviour, ReparsesWhenCacheHeaderOrOffsetsAreInconsistent)
+{
+  const std::string path = "numeric_table_cache_behaviour_tampered.txt";
+  const std::string cache_path = "numeric_table_cache_behaviour_tampered.cache";
+
+  std::ofstream(path) << "1 2\n3 4\n5 6\n";
+  const auto parsed = read_numeric_table_cached(path, cache_path);
+
+  //the header is 64 bytes, with the number of rows at byte 48, followed by the row offsets
+  const auto overwrite = [&cache_path] (std::streamoff position, std::uint64_t value)
+  {
+      std::fstream cache(cache_path, std::ios::in | std::ios::out | std::ios::binary);
+      cache.seekp(position);
+      cache.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+
+  //offsets 0 5 4 6
+  overwrite(64 + 8, 5);
+  auto table = read_numeric_table_cached(path, cache_path);
+  ASSERT_EQ(table.row_offsets(), parsed.row_offsets());
+  ASSERT_EQ(table.values(), parsed.values());
+
+  //(rows + 1) * 8 wraps around to 0, the values then seem to fill the rest of the file
+  overwrite(48, (std::uint64_t{1} << 61) - 1);
+  overwrite(56, 10);
+  table = read_numeric_table_cached(path, cache_path);
+  ASSERT_EQ(table.row_offsets(), parsed.row_offsets());
+  ASSERT_EQ(table.values(), parsed.values());
+
+  std::remove(path.c_str());
+  std::remove(cache_path.c_str());
+}
+
+TEST(numeric_table_behaviour, ThrowsWhenFileDoesNotExist)
+{
+  ASSERT_THROW(read_numeric_table("this_file_does_not_exist.txt"), std::system_error);
+}
+
+template<typename T>
+class zero_cross_contiguous_behaviour : public ::testing::Test {
+};
+
+using FloatingPointTypes = ::testing::Types<float, double>;
+TYPED_TEST_SUITE(zero_cross_contiguous_behaviour, FloatingPointTypes);
+
+TYPED_TEST(zero_cross_contiguous_behaviour, AgreesWithSinglePassIterators)
+{
+  const auto signal = random_signal<TypeParam>(1000, 7);
+  const auto signal_list = std::list<TypeParam>(signal.cbegin(), signal.cend());
+
+  for (int direction : {-1, 0, 1})
+    {
+      std::vector<TypeParam> zeros, expected_zeros;
+      zero_cross(signal.cbegin(), signal.cend(), std::back_inserter(zeros), direction);
+      zero_cross(signal_list.cbegin(), signal_list.cend(), std::back_inserter(expected_zeros), direction);
+      ASSERT_FALSE(expected_zeros.empty());
+      ASSERT_EQ(zeros, expected_zeros);
+
+      std::vector<TypeParam> filtered_zeros, expected_filtered_zeros;
+      zero_cross(signal.data(), signal.data() + signal.size(), std::back_inserter(filtered_zeros), 0.5, direction);
+      zero_cross(signal_list.cbegin(), signal_list.cend(), std::back_inserter(expected_filtered_zeros), 0.5, direction);
+      ASSERT_EQ(filtered_zeros, expected_filtered_zeros);
+    }
+}
+
+TYPED_TEST(zero_cross_contiguous_behaviour, ReturnsIteratorToSecondElementOfPair)
+{
+  auto signal = std::vector<TypeParam>(300, 1);
+  signal[250] = -1;
+
+  ASSERT_EQ(find_zero_cross(signal.begin(), signal.end()) - signal.begin(), 250);
+  ASSERT_EQ(find_zero_cross(signal.begin(), signal.end(), 1) - signal.begin(), 251);
+  ASSERT_EQ(find_zero_cross(signal.begin(), signal.begin() + 250), signal.begin() + 250);
+  ASSERT_EQ(find_zero_cross(signal.begin(), signal.begin()), signal.begin());
+}
+
+TYPED_TEST(zero_cross_contiguous_behaviour, CountAgreesWithZeroCross)
+{
+  const auto signal = random_signal<TypeParam>(1000, 13);
+  const auto signal_list = std::list<TypeParam>(signal.cbegin(), signal.cend());
+  const auto negate = [] (TypeParam x)
+  { return -x; };
+
+  for (int direction : {-1, 0, 1})
+    {
+      std::vector<TypeParam> zeros, filtered_zeros, transformed_zeros;
+      zero_cross(signal, std::back_inserter(zeros), direction);
+      zero_cross(signal, std::back_inserter(filtered_zeros), 0.5, direction);
+      zero_cross_transformed(signal, std::back_inserter(transformed_zeros), negate, 0.5, direction);
+
+      ASSERT_EQ(count_zero_cross(signal, direction), zeros.size());
+      ASSERT_EQ(count_zero_cross(signal_list, direction), zeros.size());
+      ASSERT_EQ(count_zero_cross(signal, 0.5, direction), filtered_zeros.size());
+      ASSERT_EQ(count_zero_cross(signal_list, 0.5, direction), filtered_zeros.size());
+      ASSERT_EQ(count_zero_cross_transformed(signal, negate, 0.5, direction), transformed_zeros.size());
+      ASSERT_EQ(count_zero_cross_transformed(signal, negate, -direction), zeros.size());
+    }
+
+  ASSERT_EQ(count_zero_cross(signal.cbegin(), signal.cbegin() + 1), 0u);
+  ASSERT_EQ(count_zero_cross(signal.cbegin(), signal.cbegin()), 0u);
+}
+
+TEST(zero_cross_n_behaviour, WritesFirstCrossingsAndResumes)
+{
+  const auto signal = random_signal<double>(1000, 17);
+  std::vector<double> zeros;
+  zero_cross(signal, std::back_inserter(zeros));
+  ASSERT_GT(zeros.size(), 10u);
+
+  std::vector<double> first_zeros;
+  auto position = zero_cross_n(signal.cbegin(), signal.cend(), std::back_inserter(first_zeros), 10);
+  ASSERT_THAT(first_zeros, ElementsAreArray(zeros.begin(), zeros.begin() + 10));
+  ASSERT_EQ(*position, zeros[9]);
+
+  std::vector<double> remaining_zeros;
+  position = zero_cross_n(position, signal.cend(), std::back_inserter(remaining_zeros), zeros.size());
+  ASSERT_EQ(position, signal.cend());
+  ASSERT_THAT(remaining_zeros, ElementsAreArray(zeros.begin() + 10, zeros.end()));
+
+  std::vector<double> none;
+  ASSERT_EQ(zero_cross_n(signal, std::back_inserter(none), 0), signal.cbegin());
+  ASSERT_TRUE(none.empty());
+
+  std::vector<double> filtered_zeros, first_filtered_zeros;
+  zero_cross(signal, std::back_inserter(filtered_zeros), 0.5, 1);
+  zero_cross_n(signal, std::back_inserter(first_filtered_zeros), 3, 0.5, 1);
+  ASSERT_THAT(first_filtered_zeros, ElementsAreArray(filtered_zeros.begin(), filtered_zeros.begin() + 3));
+}
+
+TEST(zero_cross_n_behaviour, StopsTransformingAfterNthCrossing)
+{
+  const auto signal = std::vector<double>{1, -1, 1, -1, 1, -1};
+  int n_calls = 0;
+  const auto counting_identity = [&n_calls] (double x)
+  {
+      ++n_calls;
+      return x;
+  };
+
+  std::vector<double> zeros;
+  const auto position = zero_cross_transformed_n(signal, std::back_inserter(zeros), 2, counting_identity);
+  ASSERT_THAT(zeros, ElementsAre(-1, 1));
+  ASSERT_EQ(position - signal.cbegin(), 2);
+  ASSERT_EQ(n_calls, 3);
+
+  zeros.clear();
+  zero_cross_transformed_n(signal, std::back_inserter(zeros), 10, counting_identity, 3.0, -1);
+  ASSERT_THAT(zeros, ElementsAre(-1, -1, -1));
+}
+
+TEST(zero_cross_parallel_behaviour, AgreesWithSequentialVersion)
+{
+  const auto signal = random_signal<double>(200000, 11);
+
+  //every pair crosses zero, including the ones straddling chunk boundaries
+  auto alternating = std::vector<int>(100000, 1);
+  for (size_t i = 0; i < alternating.size(); i += 2)
+    alternating[i] = -1;
+
+  for (int direction : {-1, 0, 1})
+    {
+      std::vector<double> expected_zeros, expected_filtered_zeros;
+      zero_cross(signal.cbegin(), signal.cend(), std::back_inserter(expected_zeros), direction);
+      zero_cross(signal.cbegin(), signal.cend(), std::back_inserter(expected_filtered_zeros), 0.5, direction);
+
+      std::vector<int> expected_alternating_zeros;
+      zero_cross(alternating.cbegin(), alternating.cend(), std::back_inserter(expected_alternating_zeros), direction);
+
+      for (unsigned n_threads : {0u, 1u, 2u, 3u, 7u})
+        {
+          std::vector<double> zeros, filtered_zeros;
+          zero_cross_parallel(signal.cbegin(), signal.cend(), std::back_inserter(zeros), n_threads, direction);
+          zero_cross_parallel(signal.cbegin(), signal.cend(), std::back_inserter(filtered_zeros),
+                              n_threads, 0.5, direction);
+          ASSERT_EQ(zeros, expected_zeros);
+          ASSERT_EQ(filtered_zeros, expected_filtered_zeros);
+
+          std::vector<int> alternating_zeros;
+          zero_cross_parallel(alternating.cbegin(), alternating.cend(), std::back_inserter(alternating_zeros),
+                              n_threads, direction);
+          ASSERT_EQ(alternating_zeros, expected_alternating_zeros);
+        }
+    }
+}
+
+TEST(zero_cross_parallel_behaviour, SupportsTransformedValues)
+{
+  using State = std::array<double, 2>;
+
+  const auto signal = random_signal<double>(100000, 5);
+  std::vector<State> states;
+  for (const auto x : signal)
+    states.push_back({x, -x});
+
+  const auto pick_second = [] (State s)
+  { return s[1]; };
+
+  std::vector<State> expected_zeros, zeros;
+  zero_cross_transformed(states.cbegin(), states.cend(), std::back_inserter(expected_zeros), pick_second, 1.0, 1);
+  zero_cross_transformed_parallel(states.cbegin(), states.cend(), std::back_inserter(zeros), 4, pick_second, 1.0, 1);
+
+  ASSERT_FALSE(zeros.empty());
+  ASSERT_EQ(zeros, expected_zeros);
+}
+
+TEST(numeric_row_reader_behaviour, ReadsSameRowsAsParseNumericTable)
+{
+  const std::string text = "# t x y\n0 1 2\n\n1 -1e-3 4 # comment\n 2.5 3 4 5 6 7 8 9 10 11 12\n3 4";
+  const auto table = parse_numeric_table(text);
+
+  //a tiny block size forces lines to span several blocks
+  std::istringstream input(text);
+  NumericRowReader reader(input, "#", 4);
+
+  std::vector<double> values;
+  std::vector<size_t> row_offsets{0};
+  for (const auto row : reader)
+    {
+      values.insert(values.end(), row.begin(), row.end());
+      row_offsets.push_back(values.size());
+    }
+
+  ASSERT_EQ(values, table.values());
+  ASSERT_EQ(row_offsets, table.row_offsets());
+}
+
+TEST(numeric_row_reader_behaviour, CanBeUsedWithZeroCrossTransformed)
+{
+  std::istringstream input("0 -1\n1 -0.5\n2 0.5\n3 1\n4 -1\n5 2\n");
+  NumericRowReader reader(input);
+
+  std::vector<double> crossing_times;
+  auto record_time = boost::make_function_output_iterator([&crossing_times] (NumericRowReader::Row row)
+                                                          { crossing_times.push_back(row[0]); });
+
+  const auto pick_second = [] (NumericRowReader::Row row)
+  { return row[1]; };
+
+  zero_cross_transformed(reader.begin(), reader.end(), record_time, pick_second);
+
+  ASSERT_EQ(crossing_times, (std::vector<double>{2, 4, 5}));
+}
+
 int main (int argc, char **argv)
 {
 